@@ -17,6 +17,13 @@
 #include <chrono>
 #include <array>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PF_CONE_SSE2 1
+#endif
 
 
 // -----------------------------------------------------------
@@ -31,6 +38,80 @@ namespace cfg {
     constexpr int MapCols = 80;
     constexpr int MapRows = 80;
 
+    // HPA*: map is cut into square chunks; long routes are turned into tiles
+    // roughly this many tiles at a time.
+    constexpr int NavClusterSize = 16;
+    constexpr int NavRefineTiles = 24;
+
+    // HPA* entrance search inflates its octile heuristic by this much. Routes
+    // through fixed border entrances rarely run straight, so the exact
+    // heuristic leaves wide bands of near-equal cost to expand; 1.1 cuts a
+    // cross-map route search ~4x for routes ~1-2% longer.
+    constexpr float NavRouteHeuristicWeight = 1.1f;
+
+    // Flow fields: how many goals stay cached, and how close (tiles) a follower
+    // gets before switching to its own short path for the exact spot.
+    constexpr int FlowFieldCacheSize = 8;
+    constexpr int FlowHandoffTiles = 3;
+
+    // AI path requests are served from a queue, this much search time per frame.
+    // Nearest to the player first, but each second spent waiting counts as
+    // PathQueueAgeTilesPerS tiles closer, so a request never waits on later ones
+    // for longer than its distance / PathQueueAgeTilesPerS seconds.
+    constexpr int PathBudgetUs = 1000;
+    constexpr float PathQueueAgeTilesPerS = 40.0f;
+
+    // Painted-over paths are patched with a detour searched in a box this many
+    // tiles around the cut before we give up and queue a full replan.
+    constexpr int PathRepairMarginTiles = 6;
+
+    // Recently solved tile paths kept for reuse (patrol loops repeat a lot)
+    constexpr int PathCacheSize = 64;
+
+    // Clearance = tiles to the nearest non-walkable tile, stored up to this cap.
+    // A*/JPS paths prefer tiles with at least PathMinClearance (2 = not touching
+    // a wall, trunk or water) and only squeeze past things when nothing else works.
+    constexpr int ClearanceCap = 8;
+    constexpr int PathMinClearance = 2;
+
+    // Tile-to-tile visibility table (PVS): each tile keeps one bit per tile within
+    // PvsRadius (centre-to-centre LOS). Past the radius, or on maps over
+    // PvsMaxTiles, LOS falls back to a raycast. Points off the tile centres trust
+    // a 0 bit as is (rarely hiding a pawn the exact ray would see). A 1 bit only
+    // holds for them if the pair's wide bit is set too: no wall or water next to
+    // any tile of the centre walk, so no ray between the two tiles can be blocked.
+    // Otherwise the exact ray decides.
+    constexpr int PvsRadius = 14;
+    constexpr int PvsMaxTiles = 128 * 128;
+
+    // Perception LOD: calm actors (Patrol/Idle) away from the player rescan at
+    // PerceptMidHz out to PerceptFarTiles and PerceptFarHz past it. Anyone within
+    // PerceptNearTiles, in a fight, hit, or in earshot of a new ping scans every tick.
+    constexpr float PerceptNearTiles = 20.0f;
+    constexpr float PerceptFarTiles = 45.0f;
+    constexpr float PerceptMidHz = 5.0f;
+    constexpr float PerceptFarHz = 2.0f;
+
+    // Actor grid for proximity queries: cell size in pixels, and how far an actor
+    // may have moved since the grid was built and still be found (it is built once
+    // per tick; AI moves a pixel or so per tick).
+    constexpr float ActorGridCellPx = 64.0f;
+    constexpr float ActorGridSlackPx = 8.0f;
+
+    // Loot drops: bucketed per LootCellPx cell for nearest-drop queries. A new drop
+    // within LootMergePx of one it only differs from in rounds (plain ammo of the
+    // same gun, or the same weapon instance) folds its rounds into it (0 = never
+    // merge). Past LootMaxDrops the oldest drops despawn.
+    constexpr float LootCellPx = 64.0f;
+    constexpr float LootMergePx = 8.0f;
+    constexpr int   LootMaxDrops = 200;
+
+    // Sound pings: a second ping from the same emitter within SoundCoalesceS of
+    // its last one moves that ping to the new noise instead of adding another. Pings are binned in
+    // SoundCellPx cells (every cell their radius reaches) for hearing checks.
+    constexpr float SoundCoalesceS = 0.3f;
+    constexpr float SoundCellPx = 256.0f;
+
     constexpr float ZoomPlayer = 1.5f;
     constexpr float ZoomSandbox = 0.8f;
 
@@ -62,6 +143,11 @@ namespace cfg {
     constexpr float FoliageMinSize = 14.0f;
     constexpr float FoliageMaxSize = 26.0f;
 
+    // Leaves between an observer and its target shorten how far off it can be
+    // spotted: range / (1 + FoliageSightFalloff * density summed along the ray),
+    // density 1 = a tile fully covered by leaves.
+    constexpr float FoliageSightFalloff = 0.6f;
+
     constexpr float StandoffRange = 180.0f;
 
     // Colors
@@ -361,6 +447,47 @@ inline Vec2 normalize(const Vec2& v) {
 
 inline float deg2rad(float d) { return d * 3.14159265f / 180.0f; }
 
+// Swept tests for moving points: p + d*t for t in [0, 1]. Entry t, or 2 = miss.
+static inline float segmentBoxEntry(float px, float py, float dx, float dy,
+    float x0, float y0, float x1, float y1) {
+    float t0 = 0.0f, t1 = 1.0f;
+    const float p[2] = { px, py }, d[2] = { dx, dy };
+    const float lo[2] = { x0, y0 }, hi[2] = { x1, y1 };
+    for (int k = 0; k < 2; ++k) {
+        if (d[k] == 0.0f) {
+            if (p[k] < lo[k] || p[k] > hi[k]) return 2.0f;
+            continue;
+        }
+        float a = (lo[k] - p[k]) / d[k], b = (hi[k] - p[k]) / d[k];
+        if (a > b) std::swap(a, b);
+        t0 = std::max(t0, a);
+        t1 = std::min(t1, b);
+        if (t0 > t1) return 2.0f;
+    }
+    return t0;
+}
+
+static inline float segmentCircleEntry(const Vec2& p, const Vec2& d, const Vec2& c, float r) {
+    const Vec2 m = p - c;
+    const float cc = lenSq(m) - r * r;
+    if (cc <= 0.0f) return 0.0f;              // starts inside
+    const float a = lenSq(d);
+    const float b = m.x * d.x + m.y * d.y;
+    if (a == 0.0f || b >= 0.0f) return 2.0f;  // not moving, or moving away
+    const float disc = b * b - a * cc;
+    if (disc < 0.0f) return 2.0f;
+    const float t = (-b - std::sqrt(disc)) / a;
+    return t <= 1.0f ? t : 2.0f;
+}
+
+static inline float segmentPointDist(const Vec2& a, const Vec2& b, const Vec2& p) {
+    const Vec2 ab = b - a;
+    const float L2 = lenSq(ab);
+    float t = L2 > 0.0f ? ((p.x - a.x) * ab.x + (p.y - a.y) * ab.y) / L2 : 0.0f;
+    t = std::clamp(t, 0.0f, 1.0f);
+    return length(p - (a + ab * t));
+}
+
 // -----------------------------------------------------------
 // Hit zones + HitBoxes (Phase W5 Option A - proper rectangles)
 // -----------------------------------------------------------
@@ -413,7 +540,6 @@ static inline float weaponZoneBias(WeaponId wid, HitZone z) {
 
 // Forward decls (implemented after Actor exists)
 static void buildDefaultHitRig(struct Actor& a);
-static bool resolveHitZone(const struct Actor& a, const Vec2& hitPos, HitZone& outZone);
 
 
 // -----------------------------------------------------------
@@ -493,6 +619,12 @@ enum class SquadIntent : uint8_t {
     Search          // move carefully toward last known contact
 };
 
+enum class PathMode : uint8_t {
+    AStar = 0,      // heap A*, every tile expanded
+    JumpPoint,      // JPS: same paths, only jump points expanded
+    Hierarchical    // HPA*: chunk entrances first, tiles refined lazily
+};
+
 
 inline const char* stateName(AIState s) {
     switch (s) {
@@ -510,6 +642,15 @@ inline const char* stateName(AIState s) {
     }
 }
 
+inline const char* pathModeName(PathMode m) {
+    switch (m) {
+    case PathMode::AStar:     return "A*";
+    case PathMode::JumpPoint: return "JPS";
+    case PathMode::Hierarchical: return "HPA*";
+    default:                  return "?";
+    }
+}
+
 // -----------------------------------------------------------
 // Map
 // -----------------------------------------------------------
@@ -540,12 +681,186 @@ struct Map {
     }
 };
 
+// -----------------------------------------------------------
+// Path search workspace (reused by every buildPath call)
+// -----------------------------------------------------------
+
+// Per-cell search state is stamped with the generation that wrote it, so a new
+// search "clears" the whole grid by bumping one counter instead of refilling arrays.
+struct PathWorkspace {
+    struct OpenNode {
+        float f = 0.0f;
+        float g = 0.0f;
+        int   idx = -1;
+    };
+
+    std::vector<float>    g;
+    std::vector<int>      parent;
+    std::vector<uint32_t> seen;     // generation that last wrote g/parent
+    std::vector<uint32_t> closed;   // generation that closed the cell
+    std::vector<OpenNode> open;     // binary heap, lowest f on top (stale entries skipped on pop)
+    std::vector<int>      cells;    // scratch output: tile indices start..goal
+
+    uint32_t generation = 0;
+    int      expanded = 0;          // nodes closed by the last search
+
+    void begin(int count) {
+        if ((int)seen.size() != count) {
+            g.assign(count, 1e9f);
+            parent.assign(count, -1);
+            seen.assign(count, 0);
+            closed.assign(count, 0);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            // Counter wrapped: old stamps would alias, so wipe them once.
+            std::fill(seen.begin(), seen.end(), 0u);
+            std::fill(closed.begin(), closed.end(), 0u);
+            generation = 1;
+        }
+        open.clear();
+        expanded = 0;
+    }
+
+    float gAt(int i) const { return seen[i] == generation ? g[i] : 1e9f; }
+    int   parentOf(int i) const { return seen[i] == generation ? parent[i] : -1; }
+    void  setG(int i, float gv, int par) {
+        g[i] = gv;
+        parent[i] = par;
+        seen[i] = generation;
+    }
+
+    bool isClosed(int i) const { return closed[i] == generation; }
+    void close(int i) { closed[i] = generation; ++expanded; }
+
+    // std heap helpers build a max-heap, so "less" means "worse":
+    // higher f is worse; on equal f prefer the deeper node (fewer re-expansions).
+    static bool worse(const OpenNode& a, const OpenNode& b) {
+        if (a.f != b.f) return a.f > b.f;
+        return a.g < b.g;
+    }
+    void push(int i, float gv, float f) {
+        open.push_back({ f, gv, i });
+        std::push_heap(open.begin(), open.end(), worse);
+    }
+    OpenNode pop() {
+        std::pop_heap(open.begin(), open.end(), worse);
+        OpenNode n = open.back();
+        open.pop_back();
+        return n;
+    }
+};
+
+// 8-connected moves: the four straight ones first, then diagonals.
+static const int   NavDC[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int   NavDR[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+static const float NavStepCost[8] = { 1.0f, 1.0f, 1.0f, 1.0f,
+    1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+// Exact 8-connected distance on open ground (admissible + consistent)
+static inline float octileDist(int dx, int dy) {
+    dx = std::abs(dx);
+    dy = std::abs(dy);
+    return float(dx + dy) + (1.41421356f - 2.0f) * float(std::min(dx, dy));
+}
+
+// -----------------------------------------------------------
+// Hierarchical nav graph (HPA*)
+// -----------------------------------------------------------
+
+// The map is cut into NavClusterSize chunks. Wherever two chunks share an open
+// stretch of border we put one or two entrances (a cell each side). Each chunk
+// keeps the walking distance between its own entrances, so a long trip is planned
+// over entrances and only turned into tiles a few legs at a time.
+struct NavCluster {
+    std::vector<int>   cells;    // entrance cells inside this chunk
+    std::vector<int>   partner;  // 2 per entrance: cell across the border, or -1
+    std::vector<float> dist;     // cells x cells walking distance inside the chunk, <0 = none
+};
+
+struct NavGraph {
+    // At most cs/2 entrances per border (runs need a blocked cell between them).
+    // Search node id = chunk * MaxEntrances + slot, which keeps the abstract
+    // search arrays small instead of map-sized.
+    static constexpr int MaxEntrances = 2 * cfg::NavClusterSize;
+
+    int cols = 0, rows = 0;      // map size (tiles)
+    int ccols = 0, crows = 0;    // chunk grid size
+
+    std::vector<NavCluster>       clusters;
+    std::vector<std::vector<int>> eastPairs;   // per chunk: (ours, theirs) pairs on the east border
+    std::vector<std::vector<int>> southPairs;  // per chunk: same for the south border
+    std::vector<int>              slot;        // cell -> index in its chunk's cells, or -1
+
+    // Query scratch
+    mutable std::vector<float> localDist;      // chunk-local Dijkstra scratch
+    mutable std::vector<std::pair<float, int>> localQueue[2];   // straight / diagonal steps
+    mutable std::vector<uint8_t> localMoves;   // per chunk-local cell: bit m = NavDC/NavDR[m] allowed
+    mutable std::vector<int8_t>  localSlot;    // per chunk-local cell: entrance slot, -1 = none
+    mutable std::vector<float> startDist;
+    mutable std::vector<float> goalDist;
+    mutable std::vector<int>   route;          // last abstract route: start, entrances.., goal
+    mutable std::vector<int>   legCells;       // refined tiles being collected
+
+    int clusterOf(int cell) const {
+        int c = cell % cols;
+        int r = cell / cols;
+        return (r / cfg::NavClusterSize) * ccols + (c / cfg::NavClusterSize);
+    }
+    void bounds(int k, int& c0, int& r0, int& c1, int& r1) const {
+        c0 = (k % ccols) * cfg::NavClusterSize;
+        r0 = (k / ccols) * cfg::NavClusterSize;
+        c1 = std::min(c0 + cfg::NavClusterSize, cols) - 1;
+        r1 = std::min(r0 + cfg::NavClusterSize, rows) - 1;
+    }
+};
+
+// -----------------------------------------------------------
+// Flow fields
+// -----------------------------------------------------------
+
+// Walking distance from every tile to one goal tile. Many actors heading for
+// the same spot share one of these and just roll downhill.
+struct FlowField {
+    int goalCell = -1;
+    uint32_t navVersion = 0;   // map state it was built for
+    uint32_t lastUsed = 0;     // LRU stamp
+    std::vector<float> dist;   // per tile octile cost, -1 = can't reach the goal
+};
+
+// -----------------------------------------------------------
+// Path cache
+// -----------------------------------------------------------
+
+// A solved start..goal tile path. Any tile on it also has its shortest path to
+// the same goal right there: the rest of the list.
+struct PathCacheEntry {
+    int startCell = -1;
+    int goalCell = -1;
+    uint32_t navVersion = 0;
+    uint32_t lastUsed = 0;     // LRU stamp
+    std::vector<int> cells;
+};
+
+// -----------------------------------------------------------
+// Path requests (time-sliced queue)
+// -----------------------------------------------------------
+
+struct PathRequest {
+    int      actor = -1;      // index into Game::actors
+    uint32_t ticket = 0;      // stale unless it still matches Actor::pathTicket
+    int      goalCell = -1;
+    Vec2     goalPos{ 0,0 };
+    float    priority = 0.0f; // distance to the player, less the aging credit; lowest served first
+};
+
 // -----------------------------------------------------------
 // Gun / Bullet / Audio
 // -----------------------------------------------------------
 
 struct Bullet {
     Vec2 pos;
+    Vec2 prev;      // where this tick's move started, for the swept hit tests
     Vec2 dir;
     float traveled = 0.0f;
     float speed = 0.0f;
@@ -556,6 +871,84 @@ struct Bullet {
     Faction src = Faction::Axis;
 };
 
+// Live bullets, one array per field. Dead ones are swap-removed, so the live
+// range stays dense and the capacity behind it is the free list: once an
+// exchange has peaked, firing and removing never allocate. Spawn sites fill a
+// Bullet and push it; the hit code reads one back with get().
+struct BulletPool {
+    std::vector<float> x, y;             // position now
+    std::vector<float> prevX, prevY;     // where this tick's move started
+    std::vector<float> dirX, dirY;
+    std::vector<float> speed, traveled, maxRange;
+    std::vector<WeaponId> wid;
+    std::vector<int> dmg;
+    std::vector<Faction> src;
+
+    int  size() const { return (int)x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void clear() {
+        x.clear(); y.clear(); prevX.clear(); prevY.clear(); dirX.clear(); dirY.clear();
+        speed.clear(); traveled.clear(); maxRange.clear(); wid.clear(); dmg.clear(); src.clear();
+    }
+
+    void push(const Bullet& b) {
+        x.push_back(b.pos.x); y.push_back(b.pos.y);
+        prevX.push_back(b.pos.x); prevY.push_back(b.pos.y);
+        dirX.push_back(b.dir.x); dirY.push_back(b.dir.y);
+        speed.push_back(b.speed); traveled.push_back(b.traveled); maxRange.push_back(b.maxRange);
+        wid.push_back(b.wid); dmg.push_back(b.dmg); src.push_back(b.src);
+    }
+
+    Bullet get(int i) const {
+        Bullet b;
+        b.pos = Vec2{ x[i], y[i] };
+        b.prev = Vec2{ prevX[i], prevY[i] };
+        b.dir = Vec2{ dirX[i], dirY[i] };
+        b.traveled = traveled[i];
+        b.speed = speed[i];
+        b.maxRange = maxRange[i];
+        b.wid = wid[i];
+        b.dmg = dmg[i];
+        b.src = src[i];
+        return b;
+    }
+
+    // The last bullet takes slot i (order is not kept)
+    void swapRemove(int i) {
+        const int last = size() - 1;
+        if (i != last) {
+            x[i] = x[last]; y[i] = y[last]; prevX[i] = prevX[last]; prevY[i] = prevY[last];
+            dirX[i] = dirX[last]; dirY[i] = dirY[last];
+            speed[i] = speed[last]; traveled[i] = traveled[last]; maxRange[i] = maxRange[last];
+            wid[i] = wid[last]; dmg[i] = dmg[last]; src[i] = src[last];
+        }
+        x.pop_back(); y.pop_back(); prevX.pop_back(); prevY.pop_back(); dirX.pop_back(); dirY.pop_back();
+        speed.pop_back(); traveled.pop_back(); maxRange.pop_back(); wid.pop_back(); dmg.pop_back(); src.pop_back();
+    }
+
+    // Straight float arrays, no branches: vectorizes
+    void integrate(float dt) {
+        const int n = size();
+        float* __restrict px = x.data();
+        float* __restrict py = y.data();
+        float* __restrict ox = prevX.data();
+        float* __restrict oy = prevY.data();
+        const float* __restrict dx = dirX.data();
+        const float* __restrict dy = dirY.data();
+        const float* __restrict sp = speed.data();
+        float* __restrict tr = traveled.data();
+        for (int i = 0; i < n; ++i) {
+            const float step = sp[i] * dt;
+            ox[i] = px[i];
+            oy[i] = py[i];
+            px[i] += dx[i] * step;
+            py[i] += dy[i] * step;
+            tr[i] += step;
+        }
+    }
+};
+
 struct LootDrop {
     Vec2 pos{ 0,0 };
 
@@ -580,20 +973,61 @@ static inline float dist2(const Vec2& a, const Vec2& b) {
     return dx * dx + dy * dy;
 }
 
-static inline int findNearestLoot(const std::vector<LootDrop>& drops, const Vec2& p, float maxDist) {
-    float best2 = maxDist * maxDist;
-    int bestIdx = -1;
-
-    for (int i = 0; i < (int)drops.size(); ++i) {
-        if (drops[i].taken) continue;
-        float d2 = dist2(drops[i].pos, p);
-        if (d2 < best2) {
-            best2 = d2;
-            bestIdx = i;
-        }
+// Drop indices bucketed by cell, CSR over a coarse grid. Drops never move, so it
+// is only rebuilt after drops are added or compacted away.
+struct LootIndex {
+    bool dirty = true;
+    int mapCols = 0, mapRows = 0;    // map it was built for
+    int cols = 0, rows = 0;
+    std::vector<int> start;
+    std::vector<int> ids;
+
+    int cellCol(float x) const { return std::clamp((int)std::floor(x / cfg::LootCellPx), 0, cols - 1); }
+    int cellRow(float y) const { return std::clamp((int)std::floor(y / cfg::LootCellPx), 0, rows - 1); }
+
+    bool stale(int mc, int mr) const { return dirty || mc != mapCols || mr != mapRows; }
+
+    void build(const std::vector<LootDrop>& drops, int mc, int mr) {
+        mapCols = mc;
+        mapRows = mr;
+        cols = std::max(1, (int)std::ceil(mc * cfg::TileSize / cfg::LootCellPx));
+        rows = std::max(1, (int)std::ceil(mr * cfg::TileSize / cfg::LootCellPx));
+        start.assign((size_t)cols * rows + 1, 0);
+        auto cellOf = [&](const LootDrop& d) { return cellRow(d.pos.y) * cols + cellCol(d.pos.x); };
+        for (const LootDrop& d : drops) ++start[cellOf(d) + 1];
+        for (size_t i = 1; i < start.size(); ++i) start[i] += start[i - 1];
+        ids.resize(drops.size());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < (int)drops.size(); ++i) ids[fill[cellOf(drops[i])]++] = i;
+        dirty = false;
+    }
+
+    // Closest untaken drop within maxDist, lowest index on a tie; -1 if none
+    int nearest(const std::vector<LootDrop>& drops, const Vec2& p, float maxDist) const {
+        return nearestWhere(drops, p, maxDist, [](const LootDrop&) { return true; });
+    }
+
+    // Same, among the drops accept() takes
+    template <class Accept>
+    int nearestWhere(const std::vector<LootDrop>& drops, const Vec2& p, float maxDist, Accept&& accept) const {
+        float best2 = maxDist * maxDist;
+        int bestIdx = -1;
+        for (int r = cellRow(p.y - maxDist); r <= cellRow(p.y + maxDist); ++r)
+            for (int c = cellCol(p.x - maxDist); c <= cellCol(p.x + maxDist); ++c) {
+                int cell = r * cols + c;
+                for (int k = start[cell]; k < start[cell + 1]; ++k) {
+                    int i = ids[k];
+                    if (drops[i].taken || !accept(drops[i])) continue;
+                    float d2 = dist2(drops[i].pos, p);
+                    if (d2 < best2 || (d2 == best2 && bestIdx >= 0 && i < bestIdx)) {
+                        best2 = d2;
+                        bestIdx = i;
+                    }
+                }
+            }
+        return bestIdx;
     }
-    return bestIdx;
-}
+};
 
 static inline void syncLootLegacyFromInst(LootDrop& d) {
     if (!d.hasInst) return;
@@ -663,8 +1097,138 @@ struct SoundPing {
     Vec2  pos;
     float radiusPx = 0.f;
     float ttl = 0.f;
+    int   emitter = -2;     // -1 player, i = actors[i], -2 = nobody (never coalesced)
+    float bornS = 0.f;      // gameTimeS when first emitted
+};
+
+// Ping indices per coarse cell, CSR; a ping sits in every cell its radius box
+// touches. Radii only shrink, so it stays valid until a ping is added or erased.
+struct SoundGrid {
+    bool dirty = true;
+    int mapCols = 0, mapRows = 0;    // map it was built for
+    int cols = 0, rows = 0;
+    std::vector<int> start;
+    std::vector<int> ids;
+
+    int cellCol(float x) const { return std::clamp((int)std::floor(x / cfg::SoundCellPx), 0, cols - 1); }
+    int cellRow(float y) const { return std::clamp((int)std::floor(y / cfg::SoundCellPx), 0, rows - 1); }
+
+    bool stale(int mc, int mr) const { return dirty || mc != mapCols || mr != mapRows; }
+
+    void build(const std::vector<SoundPing>& pings, int mc, int mr) {
+        mapCols = mc;
+        mapRows = mr;
+        cols = std::max(1, (int)std::ceil(mc * cfg::TileSize / cfg::SoundCellPx));
+        rows = std::max(1, (int)std::ceil(mr * cfg::TileSize / cfg::SoundCellPx));
+        start.assign((size_t)cols * rows + 1, 0);
+        auto each = [&](auto&& fn) {
+            for (int i = 0; i < (int)pings.size(); ++i) {
+                const SoundPing& s = pings[i];
+                for (int r = cellRow(s.pos.y - s.radiusPx); r <= cellRow(s.pos.y + s.radiusPx); ++r)
+                    for (int c = cellCol(s.pos.x - s.radiusPx); c <= cellCol(s.pos.x + s.radiusPx); ++c) fn(r * cols + c, i);
+            }
+            };
+        each([&](int cell, int) { ++start[cell + 1]; });
+        for (size_t i = 1; i < start.size(); ++i) start[i] += start[i - 1];
+        ids.resize(start.back());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        each([&](int cell, int i) { ids[fill[cell]++] = i; });   // ping order kept within a cell
+        dirty = false;
+    }
+};
+
+// Set bits in a word; plain shifts and masks, no compiler builtins
+inline int popCount64(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return int((x * 0x0101010101010101ull) >> 56);
+}
+
+// Tiles one actor can see this tick (shadowcast from its tile, clipped to its
+// vision range and cone). One bit per tile in a square window around the origin.
+// Only the vision overlay reads it. Threat checks don't look targets up in it:
+// a whole cone costs more than a few rays, and a tile bit is no exact answer for
+// a pawn standing off-centre (see the FOV bench), so they stay on losVisible.
+struct FovMask {
+    uint32_t tick = 0;
+    int originC = 0, originR = 0;
+    int radius = 0;                 // tiles
+    std::vector<uint64_t> bits;
+
+    int side() const { return 2 * radius + 1; }
+    void reset(int c, int r, int rad) {
+        originC = c; originR = r; radius = rad;
+        bits.assign((side() * side() + 63) / 64, 0);
+    }
+    void set(int c, int r) {
+        int k = (r - originR + radius) * side() + (c - originC + radius);
+        bits[k >> 6] |= 1ull << (k & 63);
+    }
+    bool test(int c, int r) const {
+        int dc = c - originC, dr = r - originR;
+        if (dc < -radius || dc > radius || dr < -radius || dr > radius) return false;
+        int k = (dr + radius) * side() + (dc + radius);
+        return (bits[k >> 6] >> (k & 63)) & 1ull;
+    }
+};
+
+// One observer's vision cone with everything per-target tests need precomputed:
+// squared ranges and the cosine of the half angle, normal and for a target
+// hiding in trees. No acos anywhere, angle <= half  <=>  dot(facing, to) >= cos(half) * |to|.
+struct ConeQuery {
+    float ox = 0, oy = 0;
+    float fx = 1, fy = 0;
+    float rangeSq = 0, cosHalf = 1;
+    float concealRangeSq = 0, concealCosHalf = 1;
+    float revealSq = 0;             // closer than this, trees don't hide you
+
+    bool test(float x, float y, bool inTrees) const {
+        float dx = x - ox, dy = y - oy;
+        float d2 = dx * dx + dy * dy;
+        bool hid = inTrees && d2 > revealSq;
+        float r2 = hid ? concealRangeSq : rangeSq;
+        float c = hid ? concealCosHalf : cosHalf;
+        return d2 >= 1e-6f && d2 <= r2 && fx * dx + fy * dy >= c * std::sqrt(d2);
+    }
 };
 
+// Range + cone + concealment over packed candidates (SoA x/y, 1 = in trees).
+// out[i] = 1 for survivors, which then go on to the LOS stage. SSE2 when the
+// compiler targets it (always on x86-64), ConeQuery::test otherwise and for the tail.
+inline void coneCullBatch(const ConeQuery& q, const float* xs, const float* ys,
+    const uint8_t* inTrees, int n, uint8_t* out) {
+    int i = 0;
+#ifdef PF_CONE_SSE2
+    const __m128 ox = _mm_set1_ps(q.ox), oy = _mm_set1_ps(q.oy);
+    const __m128 fx = _mm_set1_ps(q.fx), fy = _mm_set1_ps(q.fy);
+    const __m128 r2 = _mm_set1_ps(q.rangeSq), c = _mm_set1_ps(q.cosHalf);
+    const __m128 cr2 = _mm_set1_ps(q.concealRangeSq), cc = _mm_set1_ps(q.concealCosHalf);
+    const __m128 reveal = _mm_set1_ps(q.revealSq), eps = _mm_set1_ps(1e-6f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), ox);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), oy);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 dot = _mm_add_ps(_mm_mul_ps(fx, dx), _mm_mul_ps(fy, dy));
+
+        __m128i t = _mm_setr_epi32(inTrees[i], inTrees[i + 1], inTrees[i + 2], inTrees[i + 3]);
+        __m128 hid = _mm_and_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(t, _mm_setzero_si128())),
+            _mm_cmpgt_ps(d2, reveal));
+        __m128 rr = _mm_or_ps(_mm_and_ps(hid, cr2), _mm_andnot_ps(hid, r2));
+        __m128 cs = _mm_or_ps(_mm_and_ps(hid, cc), _mm_andnot_ps(hid, c));
+
+        __m128 ok = _mm_and_ps(_mm_cmpge_ps(d2, eps), _mm_cmple_ps(d2, rr));
+        ok = _mm_and_ps(ok, _mm_cmpge_ps(dot, _mm_mul_ps(cs, _mm_sqrt_ps(d2))));
+        int bits = _mm_movemask_ps(ok);
+        out[i] = bits & 1;
+        out[i + 1] = (bits >> 1) & 1;
+        out[i + 2] = (bits >> 2) & 1;
+        out[i + 3] = (bits >> 3) & 1;
+    }
+#endif
+    for (; i < n; ++i) out[i] = q.test(xs[i], ys[i], inTrees[i] != 0) ? 1 : 0;
+}
+
 struct Bark {
     Vec2  pos;
     std::string text;
@@ -780,6 +1344,17 @@ struct Actor {
     std::vector<Vec2> path;
     int pathIndex = -1;
 
+    // HPA*: entrance route not yet turned into tiles (see refineNavLegs)
+    std::vector<int> navRoute;
+    int navRouteIndex = -1;
+
+    // Squad-wide move target (tile); Seek follows the shared flow field there. -1 = none
+    int flowGoal = -1;
+
+    // Queued path request (0 = none pending) and the goal tile it is for
+    uint32_t pathTicket = 0;
+    int pathGoalCell = -1;
+
     // Squad scan behaviour
     bool inScan = false;     // true if this actor currently has an assigned scan slot
     Vec2 scanPos{ 0,0 };     // where to stand while scanning
@@ -787,6 +1362,111 @@ struct Actor {
     bool alive() const { return hp > 0; }
 };
 
+// Live actors hashed by grid cell and faction, CSR: bucket (hash(cell) * 4 + faction)
+// holds ids[start[b] .. start[b + 1]). The bucket count follows the actor count,
+// not the map size, so building is O(actors) even on the big maps. Queries hand
+// out candidates; callers test against the live positions, since the grid's copy
+// can be up to a tick old.
+struct ActorGrid {
+    uint32_t tick = 0;               // simTick it was built in, 0 = stale
+    int builtFor = 0;                // actors.size() at build
+    int cols = 0, rows = 0;
+    int hashShift = 32;              // buckets = 1 << (32 - hashShift)
+    std::vector<int> start;
+    std::vector<int> ids;
+    std::vector<int> cellOf;         // per entry, so hash collisions can be told apart
+    std::vector<float> xs, ys;       // positions at build time, same order as ids
+
+    int cellCol(float x) const { return std::clamp((int)std::floor(x / cfg::ActorGridCellPx), 0, cols - 1); }
+    int cellRow(float y) const { return std::clamp((int)std::floor(y / cfg::ActorGridCellPx), 0, rows - 1); }
+    int bucket(int cell) const { return int((uint32_t(cell) * 2654435761u) >> hashShift); }
+
+    void build(const std::vector<Actor>& actors, int mapCols, int mapRows, uint32_t t) {
+        cols = std::max(1, (int)std::ceil(mapCols * cfg::TileSize / cfg::ActorGridCellPx));
+        rows = std::max(1, (int)std::ceil(mapRows * cfg::TileSize / cfg::ActorGridCellPx));
+        tick = t;
+        builtFor = (int)actors.size();
+
+        int bits = 6;   // at least 64 buckets, about two per actor
+        while ((1 << bits) < 2 * (int)actors.size() && bits < 20) ++bits;
+        hashShift = 32 - bits;
+        start.assign(((size_t)1 << bits) * 4 + 1, 0);
+
+        // Counting sort by bucket
+        auto cellAt = [&](const Actor& a) { return cellRow(a.pos.y) * cols + cellCol(a.pos.x); };
+        for (const Actor& a : actors) if (a.alive()) ++start[bucket(cellAt(a)) * 4 + (int)a.team + 1];
+        for (size_t b = 1; b < start.size(); ++b) start[b] += start[b - 1];
+        ids.resize(start.back());
+        cellOf.resize(start.back());
+        xs.resize(start.back());
+        ys.resize(start.back());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < (int)actors.size(); ++i) {
+            if (!actors[i].alive()) continue;
+            int cell = cellAt(actors[i]);
+            int k = fill[bucket(cell) * 4 + (int)actors[i].team]++;
+            ids[k] = i;
+            cellOf[k] = cell;
+            xs[k] = actors[i].pos.x;
+            ys[k] = actors[i].pos.y;
+        }
+    }
+
+    // fn(id) for every actor of a faction in factionMask (bit = 1 << faction)
+    // within radius (+ slack) of (x, y), cell by cell
+    template <class Fn>
+    void query(float x, float y, float radius, unsigned factionMask, Fn&& fn) const {
+        const float r = radius + cfg::ActorGridSlackPx;
+        const float r2 = r * r;
+        const int c0 = cellCol(x - r), c1 = cellCol(x + r);
+        const int r0 = cellRow(y - r), r1 = cellRow(y + r);
+        for (int cr = r0; cr <= r1; ++cr)
+            for (int cc = c0; cc <= c1; ++cc) {
+                const int cell = cr * cols + cc;
+                const int base = bucket(cell) * 4;
+                for (int f = 0; f < 4; ++f) {
+                    if (!(factionMask & (1u << f))) continue;
+                    for (int k = start[base + f]; k < start[base + f + 1]; ++k) {
+                        if (cellOf[k] != cell) continue;
+                        float dx = xs[k] - x, dy = ys[k] - y;
+                        if (dx * dx + dy * dy <= r2) fn(ids[k]);
+                    }
+                }
+            }
+    }
+
+    // Closest live actor of the masked factions, rings of cells outward; -1 if none
+    int nearest(const std::vector<Actor>& actors, const Vec2& p, unsigned factionMask) const {
+        const int pc = cellCol(p.x), pr = cellRow(p.y);
+        int best = -1;
+        float bestD2 = std::numeric_limits<float>::max();
+        for (int ring = 0; ring < std::max(cols, rows); ++ring) {
+            // Everything in this ring is at least (ring - 1) cells away
+            float minD = std::max(0.0f, (ring - 1) * cfg::ActorGridCellPx - cfg::ActorGridSlackPx);
+            if (best >= 0 && minD * minD > bestD2) break;
+            for (int cr = pr - ring; cr <= pr + ring; ++cr) {
+                const int step = (cr == pr - ring || cr == pr + ring) ? 1 : 2 * ring;   // edge rows, else the two sides
+                for (int cc = pc - ring; cc <= pc + ring; cc += step) {
+                    if (cc < 0 || cr < 0 || cc >= cols || cr >= rows) continue;
+                    const int cell = cr * cols + cc;
+                    const int base = bucket(cell) * 4;
+                    for (int f = 0; f < 4; ++f) {
+                        if (!(factionMask & (1u << f))) continue;
+                        for (int k = start[base + f]; k < start[base + f + 1]; ++k) {
+                            if (cellOf[k] != cell) continue;
+                            const Actor& a = actors[ids[k]];
+                            if (!a.alive()) continue;
+                            float d2 = lenSq(a.pos - p);
+                            if (d2 < bestD2 || (d2 == bestD2 && ids[k] < best)) { bestD2 = d2; best = ids[k]; }
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+};
+
 // --- Build a default hit rig based on pawn size (local forward/right space)
 static void buildDefaultHitRig(Actor& a) {
     // Use w as “length along forward”, h as “width across right”
@@ -805,25 +1485,26 @@ static void buildDefaultHitRig(Actor& a) {
     };
 }
 
-static bool resolveHitZone(const Actor& a, const Vec2& hitPos, HitZone& outZone) {
+// Swept version for bullets: the first rig box the path p0 + move*t enters
+// before tMax, and its t. false = it only crossed the pawn's circle.
+static bool sweepHitZone(const Actor& a, const Vec2& p0, const Vec2& move, float tMax,
+    HitZone& outZone, float& outT) {
     Vec2 fwd = normalize(a.facing);
     Vec2 right = perpRight(fwd);
-    Vec2 rel = hitPos - a.pos;
-
-    // Actor-local coordinates (forward,right)
-    float lx = dot2(rel, fwd);
-    float ly = dot2(rel, right);
+    Vec2 rel = p0 - a.pos;
+    float lx = dot2(rel, fwd), ly = dot2(rel, right);
+    float dx = dot2(move, fwd), dy = dot2(move, right);
 
+    bool found = false;
     for (const HitBox& hb : a.hitRig) {
-        if (pointInRect(lx, ly, hb)) {
+        float t = segmentBoxEntry(lx, ly, dx, dy, hb.x, hb.y, hb.x + hb.w, hb.y + hb.h);
+        if (t <= tMax && (!found || t < outT)) {
+            outT = t;
             outZone = hb.zone;
-            return true;
+            found = true;
         }
     }
-
-    // Fallback: treat as torso if none matched
-    outZone = HitZone::Torso;
-    return false;
+    return found;
 }
 
 
@@ -1256,7 +1937,28 @@ public:
     void run();
     void cleanup();
 
+    // Headless benchmarks (Pathfinders --bench); prints results, returns exit code
+    int runBenchmarks();
+
 private:
+    // --bench passes, one per subsystem, in the order runBenchmarks runs them
+    struct BenchRig;
+    void benchPathSolvers(BenchRig& rig);
+    void benchPathFollowing(BenchRig& rig);
+    void benchPathQueue(BenchRig& rig);
+    void benchPathRepair(BenchRig& rig);
+    void benchPvs(BenchRig& rig);
+    void benchLargeNav(BenchRig& rig);
+    void benchLos(BenchRig& rig);
+    void benchTrunks(BenchRig& rig);
+    void benchLoot(BenchRig& rig);
+    void benchFoliage(BenchRig& rig);
+    void benchPerception(BenchRig& rig);
+    void benchActorGrid(BenchRig& rig);
+    void benchHearing(BenchRig& rig);
+    void benchBullets(BenchRig& rig);
+    void benchPerceptionLod(BenchRig& rig);
+
     // SDL
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
@@ -1273,15 +1975,28 @@ private:
     std::vector<Squad>  squads;
     std::vector<Vec2>   corpses;
 
-    std::vector<Bullet> bullets;
+    BulletPool bullets;
+    std::vector<int> deadBullets;   // scratch for updateBullets, kept for its capacity
     std::vector<SoundPing> sounds;
     std::vector<Bark>  barks;
-    std::vector<LootDrop> lootDrops;
+    std::vector<LootDrop> lootDrops;   // oldest first
+    mutable LootIndex lootIndex;
+    int  findNearestLoot(const Vec2& p, float maxDist) const;
+    void addLootDrop(const LootDrop& d);   // merges into a drop underfoot it only differs from in rounds
+    void updateLoot();                     // drops taken ones, enforces cfg::LootMaxDrops
 
 
     std::vector<Trunk> trunks;
     std::vector<Leaf>  leaves;
     std::vector<int>   trunkIndex; // per tile, index into trunks or -1
+    std::vector<int>   trunkCellStart;   // per tile: trunks whose collision square touches it are
+    std::vector<int>   trunkCellIds;     // trunkCellIds[trunkCellStart[i] .. trunkCellStart[i + 1])
+    std::vector<uint8_t> foliageDensity;   // per tile, leaf cover 0..255 (= 0..1 of the tile)
+    std::vector<int>   leafCellStart;    // per tile: leaves whose rect touches it are
+    std::vector<int>   leafCellIds;      // leafCellIds[leafCellStart[i] .. leafCellStart[i + 1])
+    std::vector<uint32_t> leafUnderFrame;   // canopyFrame a living pawn was under the leaf in
+    uint32_t canopyFrame = 0;
+    void markLeavesUnderPawns();             // bumps canopyFrame, sets playerUnderCanopy
 
     MissionParams missionParams;
     MissionState  mission;
@@ -1358,6 +2073,8 @@ private:
     // Map / tiles
     SDL_FRect tileRectWorld(int c, int r) const;
     bool inBoundsTile(int c, int r) const;
+    int  tileIndexAt(const Vec2& p) const;   // r * cols + c, or -1 off the map
+    Vec2 tileCenterOf(int idx) const;        // world centre of tile r * cols + c
     bool isWalkableTile(int c, int r) const;
     bool isNavWalkable(int c, int r) const;
     bool isClearLand(int c, int r) const;
@@ -1385,14 +2102,128 @@ private:
     void placeSquad(Faction f, int wx, int wy, int count);
     int  countLivingEnemies() const;
 
+    // Proximity queries go through this: built on the first ask each tick,
+    // dropped when actors move en masse (collision pass) or the world changes
+    mutable ActorGrid actorGrid;
+    mutable std::vector<int> nearIds;   // scratch for gathered candidates
+    const ActorGrid& actorGridNow() const;
+    void invalidateActorGrid() { actorGrid.tick = 0; }
+    unsigned enemyFactionMask(Faction f) const;   // bit (1 << faction) per enemy faction
+
 
 
     // Pathfinding & movement
     bool collideSolid(const SDL_FRect& r) const;
+    float sweepSolid(const Vec2& a, const Vec2& b) const;   // first wall/trunk along a->b as t, 2 = clear
     void moveWithCollide(Actor& a, const Vec2& vel, float maxSpeed, float dt);
 
     bool buildPath(const Vec2& from, const Vec2& to, Actor& a) const;
-    void clearPath(Actor& a) const;
+    void clearPath(Actor& a) const;   // also cancels a queued request
+
+    // Path cache (A*/JPS results), LRU over cfg::PathCacheSize entries
+    bool lookupPathCache(int startIdx, int goalIdx) const;   // fills pathWs.cells on a hit
+    void storePathCache(int startIdx, int goalIdx) const;    // from pathWs.cells
+    mutable std::vector<PathCacheEntry> pathCache;
+    mutable uint32_t pathCacheStamp = 0;
+    mutable int pathCacheHits = 0;
+    mutable int pathCacheSuffixHits = 0;
+    mutable int pathCacheMisses = 0;
+    bool pathCacheEnabled = true;
+
+    // AI path requests: queued, served within cfg::PathBudgetUs per frame
+    void requestPath(Actor& a, const Vec2& goal);
+    void servicePathQueue();
+    std::vector<PathRequest> pathQueue;
+    uint32_t nextPathTicket = 1;
+    int pathReqServed = 0;
+    int pathReqShared = 0;      // copied from an identical request served the same frame
+    int pathReqDeduped = 0;     // re-requests for a goal already queued
+    int pathReqCancelled = 0;   // actor died / re-requested / cleared before we got to it
+
+    // Paint edits: patch live paths that cross a newly blocked tile
+    int  repairPathsAfterBlock(int c, int r, int& requeued);  // returns paths patched
+    bool repairPath(Actor& a, int blockedCell);
+    int  firstBlockedSegment(const Actor& a, int blockedCell) const;  // -1 = path unaffected
+
+    // Grid search core: fills pathWs.cells with tile indices start..goal
+    bool searchPath(int startIdx, int goalIdx) const;      // dispatches on pathMode
+    bool searchGridPath(int startIdx, int goalIdx) const;
+    bool searchGridPathIn(int startIdx, int goalIdx, int c0, int r0, int c1, int r1) const;
+    bool searchJumpPoint(int startIdx, int goalIdx) const;
+    bool searchHierarchical(int startIdx, int goalIdx) const; // route + full refine
+    bool searchGridPathReference(int startIdx, int goalIdx) const; // old linear-scan A*, bench only
+
+    // One 8-connected step is allowed: target open, and diagonals may not
+    // squeeze past a blocked corner (walls, water, tree tiles)
+    bool navStepOk(int c, int r, int dc, int dr) const;
+
+    // JPS scan from (c,r) in direction (dc,dr): next jump point tile index, or -1
+    int jumpFrom(int c, int r, int dc, int dr, int goalIdx) const;
+
+    // Tile list -> a few waypoints an actor can walk straight between
+    bool navLineClear(const Vec2& a, const Vec2& b, float radius) const;
+    void stringPull(const std::vector<int>& cells, std::vector<Vec2>& out) const;
+
+    mutable PathWorkspace pathWs;
+    PathMode pathMode = PathMode::JumpPoint; // F9 cycles
+
+    // HPA* graph; rebuilt whole on new maps, per chunk when painting
+    NavGraph nav;
+    mutable PathWorkspace navWs;   // abstract search, indexed by entrance id
+    uint32_t navVersion = 0;   // bumped on every nav-relevant map change
+    void rebuildNavData();
+    void onNavTileChanged(int c, int r);
+    void rebuildNavBorders(int k);
+    void rebuildNavCluster(int k);
+    void navClusterMoves(int k) const;
+    void navClusterDijkstra(int k, int srcCell, std::vector<float>& out, int needFrom = 0) const;
+    bool searchAbstract(int startIdx, int goalIdx) const;     // fills nav.route
+    bool refineNavLeg(int fromCell, int toCell, std::vector<int>& out) const;
+    bool refineNavLegs(Actor& a) const;
+
+    // Connected components of walkable tiles. A 4-neighbour flood is enough: a
+    // diagonal step needs both side tiles open, so it never links anything new.
+    std::vector<int> navComp;       // per tile label, -1 = blocked
+    std::vector<int> navCompSize;   // per label; labels retired by edits stay at 0
+    int navMainComp = -1;           // largest component; spawns and objectives go here
+    std::vector<int> navCompQueue;
+    void rebuildNavComponents();
+    void updateNavComponents(int c, int r);
+    void floodNavComponent(int startCell, int label);
+    int  navComponentAt(int c, int r) const;
+    bool navReachable(int fromIdx, int toIdx) const { return navComp[fromIdx] >= 0 && navComp[fromIdx] == navComp[toIdx]; }
+
+    // Clearance layer: Chebyshev tiles to the nearest non-walkable tile (off-map
+    // counts as blocked), 0 on blocked tiles, capped at cfg::ClearanceCap.
+    std::vector<uint8_t> navClearance;
+    void rebuildClearance();
+    void updateClearance(int c, int r);
+    void clearancePass(int c0, int r0, int c1, int r1);
+    int  clearanceAt(int c, int r) const;
+
+    // Grid searches only enter tiles with navMinClear room; buildPath raises it to
+    // pathMinClearance for one search. Tiles next to the start/goal are exempt.
+    int pathMinClearance = cfg::PathMinClearance;
+    mutable int navMinClear = 1;
+    mutable int navClearSC = -1, navClearSR = -1;   // start / goal tiles
+    mutable int navClearGC = -1, navClearGR = -1;
+    bool navOpen(int c, int r) const;
+
+    // Components of the roomy tiles only, relabelled lazily after edits: tells
+    // buildPath up front when the roomy search can't succeed and it should squeeze.
+    mutable std::vector<int> navWideComp;
+    mutable uint32_t navWideVersion = 0;
+    mutable int navWideMin = 0;
+    bool navWideReachable(int fromIdx, int toIdx) const;
+
+    // Flow fields, cached per (goal tile, navVersion)
+    std::vector<FlowField> flowFields;
+    uint32_t flowUseStamp = 0;
+    int flowBuilds = 0;
+    int flowHits = 0;
+    const FlowField& flowFieldTo(int goalCell);
+    void buildFlowField(FlowField& f, int goalCell) const;
+    bool flowDirection(const FlowField& f, const Vec2& pos, Vec2& outDir) const;
 
     Vec2 findNearestCoverToward(const Vec2& from, const Vec2& toward) const;
 
@@ -1400,11 +2231,98 @@ private:
 
 
     // Sensory
+    template <class Visit>
+    bool traverseTiles(const Vec2& a, const Vec2& b, Visit&& visit) const;   // false = visit stopped it
     bool losClear(const Vec2& a, const Vec2& b) const;
+    void losClearBatch(const Vec2& from, const Vec2* targets, int count, bool* out) const;
+
+    // PVS, see cfg::PvsRadius. Built on map load, patched when painting.
+    std::vector<uint64_t> pvs;       // pvsWords per tile; empty = map too big, always raycast
+    std::vector<uint64_t> pvsWide;   // same layout: centre walk clear by a tile on every side
+    std::vector<uint8_t> pvsOpen;    // per tile: 1 = no wall/water in its 3x3
+    int pvsWords = 0;
+    void refreshPvsOpen(int c, int r);
+    void rebuildPvs();
+    void updatePvs(int c, int r);
+    bool pvsRay(int fromIdx, int toIdx, bool wide) const;       // the ray one table bit stands for
+    int  pvsLookup(const Vec2& a, const Vec2& b) const;         // 1 / 0, or -1 = ask the ray
+    bool losVisible(const Vec2& a, const Vec2& b) const;        // table bit if covered (tile-level), else losClear
+    float visionRangeFor(const Actor& a) const;                          // scaled by alarm level
+    bool inFoliage(const Vec2& p) const;
+    float foliageAlong(const Vec2& from, const Vec2& to, bool countTarget = true) const;    // density summed over the ray's tiles
+    bool foliageConceals(const Actor& a, const Vec2& targetPos) const;
+    ConeQuery coneFor(const Actor& a) const;
+    bool inVisionCone(const Actor& a, const Vec2& targetPos) const;     // range + FOV, no LOS
     bool sees(const Actor& a, const Vec2& targetPos, bool& outLOS) const;
     bool hears(const Actor& a, const SoundPing& s) const;
+    int  loudestPing(const Actor& a, float& outScore) const;   // index into sounds, -1 = hears nothing
 
     bool acquireThreat(const Actor& self, Vec2& outPos, int& outIdx, bool& outSees) const;
+    bool scanThreat(const Actor& self, Vec2& outPos, int& outIdx, bool& outSees,
+        std::vector<int>* outSeen = nullptr) const;   // outSeen: slots of every enemy seen
+
+    // acquireThreat results, kept for the tick they were computed in: the squad
+    // brain, updateAI and the vision overlay all ask about the same actor each
+    // tick. Slot 0 is the player, slot i + 1 is actors[i].
+    struct PerceptionResult {
+        uint32_t tick = 0;   // simTick it belongs to, 0 = empty
+        float nextScanS = 0.0f;   // LOD: calm distant actors reuse the result until then
+        bool found = false;
+        bool sees = false;
+        int  idx = -1;
+        Vec2 pos{ 0, 0 };
+        std::vector<int> seen;   // slots of every enemy the scan saw, for factionVisFor
+    };
+    mutable std::vector<PerceptionResult> perception;
+    mutable int perceptionScans = 0;
+    mutable int perceptionHits = 0;
+    uint32_t simTick = 1;   // bumped at the top of every update()
+    bool perceptionLod = true;   // off = every actor rescans every tick
+    float perceptionInterval(const Actor& a, const PerceptionResult& pr) const;   // 0 = every tick
+    void emitSound(const Vec2& pos, float radiusPx, float ttl, int emitter = -2);   // also wakes LOD'd listeners
+    mutable SoundGrid soundGrid;
+    void updateSounds(float dt);
+    void updateBullets(float dt);   // move, then sweep each move for the first thing it hits
+    int soundsCoalesced = 0;             // pings folded into an earlier one, for the F3 overlay
+    mutable int hearTestsTick = 0;       // hears() calls this tick / last tick
+    int hearTestsLast = 0;
+    void wakePerception(const Actor& a);
+
+    // Visible-tile masks, same slots and tick stamping as perception
+    mutable std::vector<FovMask> fovMasks;
+    mutable FovMask fovScratch;   // for actors that aren't in a slot
+    const FovMask& fovFor(const Actor& a) const;
+    void computeFov(const Actor& a, FovMask& m) const;
+    void castFovLight(FovMask& m, int row, float start, float end,
+        int xx, int xy, int yx, int yy, const Vec2& facing, float cosHalf, float rangeTiles) const;
+
+    // scanThreat's candidate batch for coneCullBatch (SoA, reused between scans)
+    struct ConeBatch {
+        std::vector<float> xs, ys;
+        std::vector<uint8_t> trees, pass;
+        std::vector<int> idx;         // -1 = player
+        void clear() { xs.clear(); ys.clear(); trees.clear(); idx.clear(); }
+        void push(const Vec2& p, bool inTrees, int i) {
+            xs.push_back(p.x); ys.push_back(p.y); trees.push_back(inTrees ? 1 : 0); idx.push_back(i);
+        }
+    };
+    mutable ConeBatch coneBatch;
+    void losCullBatch(const Vec2& eye, ConeBatch& cb) const;   // clears pass where a wall is in the way
+
+    // Who each faction can see this tick, gathered from every member's perception
+    // scan (acquireThreat, so LOD'd members cost nothing and the squad brain's own
+    // asks are cache hits). Indexed by perception slot (0 = player, i + 1 = actors[i]).
+    struct FactionVis {
+        uint32_t tick = 0;                // simTick it was built in, 0 = never
+        std::vector<uint16_t> visibleBy;  // per target: how many of us see it
+        std::vector<int> nearestObs;      // per target: closest observer's slot, -1 = unseen
+        std::vector<float> nearestD2;
+        std::vector<int> obsStart;        // per observer: its targets are obsTargets[obsStart[o] .. obsStart[o + 1])
+        std::vector<int> obsTargets;
+    };
+    mutable std::array<FactionVis, 4> factionVis;
+    mutable std::vector<uint64_t> squadSeenMark;   // updateSquadBrain: target already counted
+    const FactionVis& factionVisFor(Faction f) const;   // rebuilt on the first ask each tick
 
     // AI
     void updateAI(Actor& a, float dt);
@@ -1455,7 +2373,12 @@ private:
 // main
 // -----------------------------------------------------------
 
-int main(int, char**) {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        Game bench;
+        return bench.runBenchmarks();
+    }
+
     Game g;
     if (!g.init()) return 1;
     g.run();
@@ -1535,6 +2458,19 @@ bool Game::inBoundsTile(int c, int r) const {
     return map.inBounds(c, r);
 }
 
+int Game::tileIndexAt(const Vec2& p) const {
+    if (p.x < 0.0f || p.y < 0.0f) return -1;
+    int c = int(p.x / cfg::TileSize);
+    int r = int(p.y / cfg::TileSize);
+    if (!inBoundsTile(c, r)) return -1;
+    return r * map.cols + c;
+}
+
+Vec2 Game::tileCenterOf(int idx) const {
+    SDL_FRect tr = tileRectWorld(idx % map.cols, idx / map.cols);
+    return Vec2{ tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f };
+}
+
 bool Game::isWalkableTile(int c, int r) const {
     Tile t = map.at(c, r);
     if (t == Tile::Land || t == Tile::Tree) return true;
@@ -1755,6 +2691,115 @@ void Game::rebuildFoliage() {
             leaves.push_back(lf);
         }
     }
+
+    // Trunk collision buckets: every tile a trunk's square reaches (a wide trunk
+    // near a tile edge spills into the neighbours)
+    auto trunkTiles = [&](const Trunk& t, int& c0, int& r0, int& c1, int& r1) {
+        float half = t.dia * 0.5f;
+        c0 = std::max(0, (int)std::floor((t.center.x - half) / cfg::TileSize));
+        r0 = std::max(0, (int)std::floor((t.center.y - half) / cfg::TileSize));
+        c1 = std::min(map.cols - 1, (int)std::floor((t.center.x + half) / cfg::TileSize));
+        r1 = std::min(map.rows - 1, (int)std::floor((t.center.y + half) / cfg::TileSize));
+        };
+    trunkCellStart.assign(map.cols * map.rows + 1, 0);
+    for (const auto& t : trunks) {
+        int c0, r0, c1, r1;
+        trunkTiles(t, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c) ++trunkCellStart[r * map.cols + c + 1];
+    }
+    for (size_t i = 1; i < trunkCellStart.size(); ++i) trunkCellStart[i] += trunkCellStart[i - 1];
+    trunkCellIds.resize(trunkCellStart.back());
+    {
+        std::vector<int> fill(trunkCellStart.begin(), trunkCellStart.end() - 1);
+        for (int ti = 0; ti < (int)trunks.size(); ++ti) {
+            int c0, r0, c1, r1;
+            trunkTiles(trunks[ti], c0, r0, c1, r1);
+            for (int r = r0; r <= r1; ++r)
+                for (int c = c0; c <= c1; ++c) trunkCellIds[fill[r * map.cols + c]++] = ti;
+        }
+    }
+
+    // Leaves bucketed by the tiles their rects touch, for the see-through test
+    auto leafTiles = [&](const Leaf& lf, int& c0, int& r0, int& c1, int& r1) {
+        c0 = std::max(0, (int)std::floor(lf.rect.x / cfg::TileSize));
+        r0 = std::max(0, (int)std::floor(lf.rect.y / cfg::TileSize));
+        c1 = std::min(map.cols - 1, (int)std::floor((lf.rect.x + lf.rect.w) / cfg::TileSize));
+        r1 = std::min(map.rows - 1, (int)std::floor((lf.rect.y + lf.rect.h) / cfg::TileSize));
+        };
+    leafCellStart.assign(map.cols * map.rows + 1, 0);
+    for (const auto& lf : leaves) {
+        int c0, r0, c1, r1;
+        leafTiles(lf, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c) ++leafCellStart[r * map.cols + c + 1];
+    }
+    for (size_t i = 1; i < leafCellStart.size(); ++i) leafCellStart[i] += leafCellStart[i - 1];
+    leafCellIds.resize(leafCellStart.back());
+    {
+        std::vector<int> fill(leafCellStart.begin(), leafCellStart.end() - 1);
+        for (int li = 0; li < (int)leaves.size(); ++li) {
+            int c0, r0, c1, r1;
+            leafTiles(leaves[li], c0, r0, c1, r1);
+            for (int r = r0; r <= r1; ++r)
+                for (int c = c0; c <= c1; ++c) leafCellIds[fill[r * map.cols + c]++] = li;
+        }
+    }
+    leafUnderFrame.assign(leaves.size(), 0);
+
+    // Leaf cover per tile, summed over overlapping rects (so clumps count double)
+    // and clamped at a full tile
+    const float T = (float)cfg::TileSize;
+    std::vector<float> cover(map.cols * map.rows, 0.0f);
+    for (const auto& lf : leaves) {
+        int c0 = std::max(0, (int)std::floor(lf.rect.x / T));
+        int r0 = std::max(0, (int)std::floor(lf.rect.y / T));
+        int c1 = std::min(map.cols - 1, (int)std::floor((lf.rect.x + lf.rect.w) / T));
+        int r1 = std::min(map.rows - 1, (int)std::floor((lf.rect.y + lf.rect.h) / T));
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c) {
+                float ow = std::min(lf.rect.x + lf.rect.w, (c + 1) * T) - std::max(lf.rect.x, c * T);
+                float oh = std::min(lf.rect.y + lf.rect.h, (r + 1) * T) - std::max(lf.rect.y, r * T);
+                if (ow > 0.0f && oh > 0.0f) cover[r * map.cols + c] += ow * oh;
+            }
+    }
+    foliageDensity.resize(cover.size());
+    for (size_t i = 0; i < cover.size(); ++i) {
+        foliageDensity[i] = (uint8_t)std::lround(std::min(1.0f, cover[i] / (T * T)) * 255.0f);
+    }
+}
+
+// Leaves over a pawn are drawn see-through. Each pawn only looks at the leaves
+// binned under its own tiles, instead of every leaf checking every pawn.
+void Game::markLeavesUnderPawns() {
+    ++canopyFrame;
+    playerUnderCanopy = false;
+    if (leafCellStart.size() != size_t(map.cols * map.rows + 1)) return;
+
+    auto mark = [&](const SDL_FRect& r) {
+        bool any = false;
+        int c0 = std::max(0, (int)std::floor(r.x / cfg::TileSize));
+        int r0 = std::max(0, (int)std::floor(r.y / cfg::TileSize));
+        int c1 = std::min(map.cols - 1, (int)std::floor((r.x + r.w) / cfg::TileSize));
+        int r1 = std::min(map.rows - 1, (int)std::floor((r.y + r.h) / cfg::TileSize));
+        for (int rr = r0; rr <= r1; ++rr)
+            for (int cc = c0; cc <= c1; ++cc) {
+                int cell = rr * map.cols + cc;
+                for (int k = leafCellStart[cell]; k < leafCellStart[cell + 1]; ++k) {
+                    int li = leafCellIds[k];
+                    if (SDL_HasIntersectionF(&leaves[li].rect, &r)) {
+                        leafUnderFrame[li] = canopyFrame;
+                        any = true;
+                    }
+                }
+            }
+        return any;
+        };
+
+    if (playerPresent) playerUnderCanopy = mark(rectFrom(player.pos, player.w, player.h));
+    for (const auto& e : actors) {
+        if (e.alive()) mark(rectFrom(e.pos, e.w, e.h));
+    }
 }
 
 void Game::drawTrunkOctagon(const Trunk& t) {
@@ -1784,6 +2829,8 @@ void Game::initWorld() {
 
     trunkIndex.assign(map.cols * map.rows, -1);
     rebuildFoliage();
+    rebuildNavData();
+    rebuildPvs();
 
     Vec2 spawn{
         map.cols * cfg::TileSize * 0.5f,
@@ -1812,10 +2859,17 @@ void Game::initWorld() {
     missionParams = MissionParams{};
     squads.clear();
     actors.clear();
+    pathQueue.clear();
+    perception.clear();
+    fovMasks.clear();
+    for (auto& v : factionVis) v.tick = 0;
+    invalidateActorGrid();
     corpses.clear();
     bullets.clear();
     lootDrops.clear();
+    lootIndex.dirty = true;
     sounds.clear();
+    soundGrid.dirty = true;
     barks.clear();
     undo = std::stack<PaintOp>();
 
@@ -2212,37 +3266,14 @@ void Game::drawWorld() {
     }
 
     // Foliage + trunks (can obscure; extraction is redrawn later)
-    playerUnderCanopy = false;
+    markLeavesUnderPawns();
 
-    for (const auto& leaf : leaves) {
-        SDL_FRect lr = leaf.rect;
+    for (size_t li = 0; li < leaves.size(); ++li) {
+        SDL_FRect lr = leaves[li].rect;
         lr.x -= camX;
         lr.y -= camY;
 
-        bool underAny = false;
-
-        if (playerPresent) {
-            SDL_FRect pr = rectFrom(player.pos, player.w, player.h);
-            pr.x -= camX;
-            pr.y -= camY;
-            if (SDL_HasIntersectionF(&lr, &pr)) {
-                underAny = true;
-                playerUnderCanopy = true;
-            }
-        }
-
-        for (const auto& e : actors) {
-            if (!e.alive()) continue;
-            SDL_FRect er = rectFrom(e.pos, e.w, e.h);
-            er.x -= camX;
-            er.y -= camY;
-            if (SDL_HasIntersectionF(&lr, &er)) {
-                underAny = true;
-                break;
-            }
-        }
-
-        if (underAny) {
+        if (leafUnderFrame[li] == canopyFrame) {
             SDL_SetRenderDrawColor(
                 renderer,
                 cfg::ColLeaf.r, cfg::ColLeaf.g, cfg::ColLeaf.b,
@@ -2291,10 +3322,10 @@ bool Game::inScreen(float x, float y, float margin) const {
 
 void Game::drawBullets() {
     setDraw(renderer, cfg::ColBullet);
-    for (const auto& bu : bullets) {
+    for (int i = 0; i < bullets.size(); ++i) {
         SDL_FRect br{
-            bu.pos.x - 2 - camX,
-            bu.pos.y - 2 - camY,
+            bullets.x[i] - 2 - camX,
+            bullets.y[i] - 2 - camY,
             4,4
         };
         SDL_RenderFillRectF(renderer, &br);
@@ -2370,30 +3401,41 @@ void Game::drawVisionOutlineAndRay(const Actor& a) {
     float baseAng = std::atan2(dir.y, dir.x);
     float ang0 = baseAng - halfFov;
     float ang1 = baseAng + halfFov;
-    float R = a.visionRange * (1.0f + 0.12f * (float)mission.alarmLevel);
+    float R = visionRangeFor(a);
+
+    // Visibility polygon: each spoke runs out through the FOV mask until it leaves
+    // the visible tiles (bit lookups only, no extra map rays)
+    const FovMask& fov = fovFor(a);
+    const int segs = 28;
+    const float step = cfg::TileSize * 0.25f;
+    Vec2 pts[segs + 1];
+    for (int i = 0; i <= segs; i++) {
+        float t = ang0 + (ang1 - ang0) * (float(i) / segs);
+        Vec2 d(std::cos(t), std::sin(t));
+        float reach = 0.0f;
+        while (reach < R) {
+            float next = std::min(R, reach + step);
+            Vec2 q = a.pos + d * next;
+            if (!fov.test((int)std::floor(q.x / cfg::TileSize), (int)std::floor(q.y / cfg::TileSize))) break;
+            reach = next;
+        }
+        pts[i] = a.pos + d * reach;
+    }
 
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 80);
-    Vec2 p0 = a.pos + Vec2(std::cos(ang0), std::sin(ang0)) * R;
-    Vec2 p1 = a.pos + Vec2(std::cos(ang1), std::sin(ang1)) * R;
     SDL_RenderDrawLineF(renderer,
         a.pos.x - camX, a.pos.y - camY,
-        p0.x - camX, p0.y - camY
+        pts[0].x - camX, pts[0].y - camY
     );
     SDL_RenderDrawLineF(renderer,
         a.pos.x - camX, a.pos.y - camY,
-        p1.x - camX, p1.y - camY
+        pts[segs].x - camX, pts[segs].y - camY
     );
-
-    const int segs = 28;
-    Vec2 prev = p0;
     for (int i = 1; i <= segs; i++) {
-        float t = ang0 + (ang1 - ang0) * (float(i) / segs);
-        Vec2 pt = a.pos + Vec2(std::cos(t), std::sin(t)) * R;
         SDL_RenderDrawLineF(renderer,
-            prev.x - camX, prev.y - camY,
-            pt.x - camX, pt.y - camY
+            pts[i - 1].x - camX, pts[i - 1].y - camY,
+            pts[i].x - camX, pts[i].y - camY
         );
-        prev = pt;
     }
 
     Vec2 tgtPos = a.pos;
@@ -2512,7 +3554,7 @@ void Game::drawActors() {
 
         if (lootMode && playerPresent && player.alive()) {
             // Refresh lootIdx each frame so it follows the nearest drop (optional)
-            int li = findNearestLoot(lootDrops, player.pos, lootRadius);
+            int li = findNearestLoot(player.pos, lootRadius);
             if (li >= 0) lootIdx = li;
 
             if (lootIdx >= 0 && lootIdx < (int)lootDrops.size()) {
@@ -2908,10 +3950,13 @@ void Game::drawHUD() {
 
     char buf[128];
     std::snprintf(buf, sizeof(buf),
-        "CAM (%.0f, %.0f) | WORLD %dx%d",
+        "CAM (%.0f, %.0f) | WORLD %dx%d | PATH %s (F9) queue %d cache %d+%d/%d",
         camX, camY,
         map.cols * cfg::TileSize,
-        map.rows * cfg::TileSize);
+        map.rows * cfg::TileSize,
+        pathModeName(pathMode),
+        (int)pathQueue.size(),
+        pathCacheHits, pathCacheSuffixHits, pathCacheMisses);
     drawText(buf, 10, y, cfg::ColUI);
     y += 18;
 
@@ -2934,6 +3979,7 @@ Vec2 Game::randomWalkablePos(int marginTiles) const {
         int c = irand(marginTiles, map.cols - 1 - marginTiles);
         int r = irand(marginTiles, map.rows - 1 - marginTiles);
         if (!isNavWalkable(c, r)) continue;
+        if (navComponentAt(c, r) != navMainComp) continue;
         SDL_FRect tr = tileRectWorld(c, r);
         return Vec2{ tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f };
     }
@@ -2948,14 +3994,14 @@ Vec2 Game::randomClearPos(int marginTiles,
 
     Vec2 fallback = randomWalkablePos(marginTiles);
 
-    // How far from tree trunks we want to be (px)
-    const float trunkClear = cfg::PawnSize * 2.4f;
-    const float trunkClearSq = trunkClear * trunkClear;
-
     for (int tries = 0; tries < 512; ++tries) {
         int c = irand(marginTiles, map.cols - 1 - marginTiles);
         int r = irand(marginTiles, map.rows - 1 - marginTiles);
         if (!isClearLand(c, r)) continue;
+        // Only places the rest of the map can actually walk to
+        if (navComponentAt(c, r) != navMainComp) continue;
+        // Nothing solid in the 8 tiles around us: no walls, water or tree trunks
+        if (clearanceAt(c, r) < 2) continue;
 
         SDL_FRect tr = tileRectWorld(c, r);
         Vec2 p{ tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f };
@@ -2971,29 +4017,6 @@ Vec2 Game::randomClearPos(int marginTiles,
         }
         if (bad) continue;
 
-        // Also ensure immediate neighbors aren't walls/water
-        bool neighborBlocked = false;
-        for (int dr = -1; dr <= 1 && !neighborBlocked; ++dr) {
-            for (int dc = -1; dc <= 1 && !neighborBlocked; ++dc) {
-                int nc = c + dc, nr = r + dr;
-                if (!inBoundsTile(nc, nr)) { neighborBlocked = true; break; }
-                Tile t = map.at(nc, nr);
-                if (t == Tile::Wall || t == Tile::Water) {
-                    neighborBlocked = true;
-                }
-            }
-        }
-        if (neighborBlocked) continue;
-
-        // NEW: avoid being too close to tree trunks (no spawning inside trunks)
-        for (const auto& t : trunks) {
-            if (lenSq(p - t.center) < trunkClearSq) {
-                bad = true;
-                break;
-            }
-        }
-        if (bad) continue;
-
         return p;
     }
     return fallback;
@@ -3003,10 +4026,14 @@ Vec2 Game::randomClearPos(int marginTiles,
 Vec2 Game::randomOpenCellAround(const Vec2& center, int radiusTiles) const {
     int baseC = int(center.x / cfg::TileSize);
     int baseR = int(center.y / cfg::TileSize);
+    // Stay on the centre's side of any wall; a centre on a blocked tile uses the main area
+    int comp = navComponentAt(baseC, baseR);
+    if (comp < 0) comp = navMainComp;
     for (int tries = 0; tries < 128; ++tries) {
         int c = baseC + irand(-radiusTiles, radiusTiles);
         int r = baseR + irand(-radiusTiles, radiusTiles);
         if (!isNavWalkable(c, r)) continue;
+        if (navComponentAt(c, r) != comp) continue;
         SDL_FRect tr = tileRectWorld(c, r);
         return Vec2{ tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f };
     }
@@ -3033,24 +4060,61 @@ bool Game::collideSolid(const SDL_FRect& r) const {
         }
     }
 
-    // Narrow trunk collision: small square around trunk center
-    for (const auto& t : trunks) {
-        float half = t.dia * 0.5f;
-        SDL_FRect tr{
-            t.center.x - half,
-            t.center.y - half,
-            t.dia,
-            t.dia
-        };
-        SDL_FRect rr2 = r;
-        if (SDL_HasIntersectionF(&tr, &rr2)) {
-            return true;
+    // Narrow trunk collision: small square around trunk center. Only trunks
+    // bucketed under the rect's tiles can touch it.
+    if (trunkCellStart.size() != size_t(map.cols * map.rows + 1)) return false;
+    for (int rr = r0; rr <= r1; ++rr) {
+        for (int cc = c0; cc <= c1; ++cc) {
+            int cell = rr * map.cols + cc;
+            for (int k = trunkCellStart[cell]; k < trunkCellStart[cell + 1]; ++k) {
+                const Trunk& t = trunks[trunkCellIds[k]];
+                float half = t.dia * 0.5f;
+                SDL_FRect tr{
+                    t.center.x - half,
+                    t.center.y - half,
+                    t.dia,
+                    t.dia
+                };
+                SDL_FRect rr2 = r;
+                if (SDL_HasIntersectionF(&tr, &rr2)) {
+                    return true;
+                }
+            }
         }
     }
 
     return false;
 }
 
+// Bullets: the segment walks its tiles in order and stops at the first wall or
+// water one. Trunk squares are grown by the 2 px the old 4x4 bullet rect had.
+float Game::sweepSolid(const Vec2& a, const Vec2& b) const {
+    const float T = cfg::TileSize;
+    const Vec2 d = b - a;
+    const bool buckets = trunkCellStart.size() == size_t(map.cols * map.rows + 1);
+    float best = 2.0f;
+    traverseTiles(a, b, [&](int c, int r) {
+        Tile t = map.at(c, r);   // off-map reads as Wall
+        if (t == Tile::Wall || t == Tile::Water) {
+            // The walk only visits tiles the segment touches; a miss here is
+            // float noise at a corner, so count it as hit at the end
+            float tw = segmentBoxEntry(a.x, a.y, d.x, d.y, c * T, r * T, (c + 1) * T, (r + 1) * T);
+            best = std::min(best, std::min(tw, 1.0f));
+            return false;
+        }
+        if (!buckets) return true;
+        int cell = r * map.cols + c;
+        for (int k = trunkCellStart[cell]; k < trunkCellStart[cell + 1]; ++k) {
+            const Trunk& tr = trunks[trunkCellIds[k]];
+            float half = tr.dia * 0.5f + 2.0f;
+            best = std::min(best, segmentBoxEntry(a.x, a.y, d.x, d.y,
+                tr.center.x - half, tr.center.y - half, tr.center.x + half, tr.center.y + half));
+        }
+        return true;
+        });
+    return best;
+}
+
 void Game::moveWithCollide(Actor& a, const Vec2& desiredVel, float /*maxSpeed*/, float dt) {
     Vec2 vel = desiredVel;
     SDL_FRect r = rectFrom(a.pos, a.w, a.h);
@@ -3084,11 +4148,18 @@ void Game::resolveActorCollisions(float /*dt*/) {
     const float minSepSq = minSep * minSep;
 
     // Simple pairwise separation: keep AI from overlapping, but don't shove into walls.
-    for (size_t i = 0; i < actors.size(); ++i) {
+    // Pairs come from the actor grid (rebuilt here, everyone just moved), in the
+    // same i < j order as the old all-pairs loop.
+    invalidateActorGrid();
+    const ActorGrid& grid = actorGridNow();
+    for (int i = 0; i < (int)actors.size(); ++i) {
         Actor& a = actors[i];
         if (!a.alive()) continue;
 
-        for (size_t j = i + 1; j < actors.size(); ++j) {
+        nearIds.clear();
+        grid.query(a.pos.x, a.pos.y, minSep, 0xFu, [&](int j) { if (j > i) nearIds.push_back(j); });
+        std::sort(nearIds.begin(), nearIds.end());
+        for (int j : nearIds) {
             Actor& b = actors[j];
             if (!b.alive()) continue;
 
@@ -3130,58 +4201,1104 @@ void Game::resolveActorCollisions(float /*dt*/) {
 }
 
 
-bool Game::buildPath(const Vec2& start, const Vec2& goal, Actor& a) const {
+bool Game::searchGridPath(int sIdx, int gIdx) const {
+    return searchGridPathIn(sIdx, gIdx, 0, 0, map.cols - 1, map.rows - 1);
+}
+
+// Same search, but never leaves the tile box c0..c1 x r0..r1 (HPA* leg refinement).
+bool Game::searchGridPathIn(int sIdx, int gIdx, int c0, int r0, int c1, int r1) const {
     const int cols = map.cols;
-    const int rows = map.rows;
-    const int count = cols * rows;
+    const int gc = gIdx % cols;
+    const int gr = gIdx / cols;
 
-    auto toIndex = [&](int c, int r) {
-        return r * cols + c;
-        };
+    auto hfun = [&](int c, int r) { return octileDist(c - gc, r - gr); };
 
-    int sc = int(start.x / cfg::TileSize);
-    int sr = int(start.y / cfg::TileSize);
-    int gc = int(goal.x / cfg::TileSize);
-    int gr = int(goal.y / cfg::TileSize);
+    PathWorkspace& ws = pathWs;
+    ws.begin(cols * map.rows);
+    ws.cells.clear();
 
-    if (!inBoundsTile(sc, sr) || !inBoundsTile(gc, gr)) {
-        return false;
+    ws.setG(sIdx, 0.0f, -1);
+    ws.push(sIdx, 0.0f, hfun(sIdx % cols, sIdx / cols));
+
+    bool found = false;
+    while (!ws.open.empty()) {
+        PathWorkspace::OpenNode n = ws.pop();
+        int cur = n.idx;
+        if (ws.isClosed(cur) || n.g > ws.gAt(cur)) continue; // stale heap entry
+        if (cur == gIdx) {
+            found = true;
+            break;
+        }
+        ws.close(cur);
+
+        int cc = cur % cols;
+        int rr = cur / cols;
+        for (int k = 0; k < 8; ++k) {
+            int nc = cc + NavDC[k];
+            int nr = rr + NavDR[k];
+            if (nc < c0 || nc > c1 || nr < r0 || nr > r1) continue;
+            if (!navStepOk(cc, rr, NavDC[k], NavDR[k])) continue;
+
+            int ni = nr * cols + nc;
+            if (ws.isClosed(ni)) continue;
+            float tentativeG = n.g + NavStepCost[k];
+            if (tentativeG < ws.gAt(ni)) {
+                ws.setG(ni, tentativeG, cur);
+                ws.push(ni, tentativeG, tentativeG + hfun(nc, nr));
+            }
+        }
     }
-    if (!isNavWalkable(sc, sr) || !isNavWalkable(gc, gr)) {
-        return false;
+
+    if (!found) return false;
+
+    for (int cur = gIdx; cur != -1; cur = ws.parentOf(cur)) {
+        ws.cells.push_back(cur);
     }
+    std::reverse(ws.cells.begin(), ws.cells.end());
+    return true;
+}
 
-    std::vector<float> gscore(count, 1e9f);
-    std::vector<float> fscore(count, 1e9f);
-    std::vector<int>   parent(count, -1);
-    std::vector<bool>  openFlag(count, false);
-    std::vector<bool>  closed(count, false);
+bool Game::navStepOk(int c, int r, int dc, int dr) const {
+    // map.at() reads off-map tiles as Wall, so this doubles as the bounds check
+    if (!navOpen(c + dc, r + dr)) return false;
+    if (dc != 0 && dr != 0) {
+        return navOpen(c + dc, r) && navOpen(c, r + dr);
+    }
+    return true;
+}
 
-    auto hfun = [&](int c, int r) {
-        float dx = float(c - gc);
-        float dy = float(r - gr);
-        return std::sqrt(dx * dx + dy * dy);
+// Walks a pawn-wide strip from a to b: the centre line plus one line on each side
+// at +-radius. Every tile a line touches must be Land; traverseTiles checks both
+// side tiles at exact corners, so pawns never clip a corner either.
+bool Game::navLineClear(const Vec2& a, const Vec2& b, float radius) const {
+    auto walk = [&](const Vec2& p0, const Vec2& p1) {
+        return traverseTiles(p0, p1, [&](int c, int r) { return isNavWalkable(c, r); });
         };
 
-    struct Node {
-        int idx;
-        float f;
-    };
+    Vec2 d{ b.x - a.x, b.y - a.y };
+    float len = std::sqrt(d.x * d.x + d.y * d.y);
+    if (!walk(a, b)) return false;
+    if (len < 1e-3f || radius <= 0.0f) return true;
 
-    std::vector<Node> open;
-    int sIdx = toIndex(sc, sr);
-    gscore[sIdx] = 0.0f;
-    fscore[sIdx] = hfun(sc, sr);
-    open.push_back({ sIdx, fscore[sIdx] });
-    openFlag[sIdx] = true;
+    Vec2 n{ -d.y / len * radius, d.x / len * radius };
+    return walk(a + n, b + n) && walk(a - n, b - n);
+}
 
-    auto popBest = [&]() -> int {
-        int best = -1;
-        float bestF = 1e9f;
-        for (int i = 0; i < (int)open.size(); ++i) {
-            if (open[i].f < bestF) {
-                bestF = open[i].f;
-                best = i;
+// Greedy string pull: from each anchor, keep the farthest following tile that is
+// still in straight pawn-wide view. Output runs from the first tile centre to the
+// last, so callers can treat it exactly like the old per-tile path.
+void Game::stringPull(const std::vector<int>& cells, std::vector<Vec2>& out) const {
+    out.clear();
+    if (cells.empty()) return;
+
+    const float radius = cfg::PawnSize * 0.75f;
+    const size_t n = cells.size();
+    size_t anchor = 0;
+    out.push_back(tileCenterOf(cells[0]));
+    while (anchor + 1 < n) {
+        const Vec2 from = tileCenterOf(cells[anchor]);
+        size_t j = anchor + 1;
+        while (j + 1 < n && navLineClear(from, tileCenterOf(cells[j + 1]), radius)) ++j;
+        out.push_back(tileCenterOf(cells[j]));
+        anchor = j;
+    }
+}
+
+bool Game::searchPath(int sIdx, int gIdx) const {
+    switch (pathMode) {
+    case PathMode::JumpPoint: return searchJumpPoint(sIdx, gIdx);
+    case PathMode::Hierarchical: return searchHierarchical(sIdx, gIdx);
+    case PathMode::AStar:
+    default:                  return searchGridPath(sIdx, gIdx);
+    }
+}
+
+// -----------------------------------------------------------
+// Jump Point Search (8-connected, no corner cutting)
+// -----------------------------------------------------------
+// Every straight step costs 1 and every diagonal sqrt(2), so most optimal paths are
+// interchangeable. Scans run straight or diagonal without touching the open list
+// and only stop where a turn is actually forced by a blocked tile behind us;
+// diagonal scans also stop wherever one of their two straight sub-scans does.
+// Online scans, no precompute, so painting tiles needs nothing rebuilt.
+
+int Game::jumpFrom(int c, int r, int dc, int dr, int goalIdx) const {
+    auto open = [&](int x, int y) { return navOpen(x, y); };
+
+    for (;;) {
+        if (!navStepOk(c, r, dc, dr)) return -1;
+        c += dc;
+        r += dr;
+
+        int idx = r * map.cols + c;
+        if (idx == goalIdx) return idx;
+
+        if (dc != 0 && dr != 0) {
+            if (jumpFrom(c, r, dc, 0, goalIdx) != -1 ||
+                jumpFrom(c, r, 0, dr, goalIdx) != -1) {
+                return idx;
+            }
+        }
+        else if (dc != 0) {
+            // Side tile open here but blocked one step back -> forced turn
+            if ((open(c, r - 1) && !open(c - dc, r - 1)) ||
+                (open(c, r + 1) && !open(c - dc, r + 1))) {
+                return idx;
+            }
+        }
+        else {
+            if ((open(c - 1, r) && !open(c - 1, r - dr)) ||
+                (open(c + 1, r) && !open(c + 1, r - dr))) {
+                return idx;
+            }
+        }
+    }
+}
+
+bool Game::searchJumpPoint(int sIdx, int gIdx) const {
+    const int cols = map.cols;
+    const int gc = gIdx % cols;
+    const int gr = gIdx / cols;
+
+    auto hfun = [&](int c, int r) { return octileDist(c - gc, r - gr); };
+    auto open = [&](int x, int y) { return navOpen(x, y); };   // same tests as jumpFrom
+
+    PathWorkspace& ws = pathWs;
+    ws.begin(cols * map.rows);
+    ws.cells.clear();
+
+    ws.setG(sIdx, 0.0f, -1);
+    ws.push(sIdx, 0.0f, hfun(sIdx % cols, sIdx / cols));
+
+    bool found = false;
+    while (!ws.open.empty()) {
+        PathWorkspace::OpenNode n = ws.pop();
+        int cur = n.idx;
+        if (ws.isClosed(cur) || n.g > ws.gAt(cur)) continue; // stale heap entry
+        if (cur == gIdx) {
+            found = true;
+            break;
+        }
+        ws.close(cur);
+
+        int cc = cur % cols;
+        int rr = cur / cols;
+
+        // Directions worth scanning, from how we arrived here
+        int dirC[8], dirR[8];
+        int dirCount = 0;
+        auto addDir = [&](int dc, int dr) {
+            dirC[dirCount] = dc;
+            dirR[dirCount] = dr;
+            ++dirCount;
+            };
+
+        int par = ws.parentOf(cur);
+        if (par == -1) {
+            for (int k = 0; k < 8; ++k) addDir(NavDC[k], NavDR[k]);
+        }
+        else {
+            int pc = par % cols;
+            int pr = par / cols;
+            int dx = (cc > pc) - (cc < pc);
+            int dy = (rr > pr) - (rr < pr);
+            if (dx != 0 && dy != 0) {
+                addDir(dx, 0);
+                addDir(0, dy);
+                addDir(dx, dy);
+            }
+            else if (dx != 0) {
+                // A side is only worth turning into where it was blocked one step
+                // back; otherwise the diagonal from that step got there cheaper
+                addDir(dx, 0);
+                for (int s = -1; s <= 1; s += 2) {
+                    if (open(cc, rr + s) && !open(cc - dx, rr + s)) {
+                        addDir(dx, s);
+                        addDir(0, s);
+                    }
+                }
+            }
+            else {
+                addDir(0, dy);
+                for (int s = -1; s <= 1; s += 2) {
+                    if (open(cc + s, rr) && !open(cc + s, rr - dy)) {
+                        addDir(s, dy);
+                        addDir(s, 0);
+                    }
+                }
+            }
+        }
+
+        for (int k = 0; k < dirCount; ++k) {
+            int j = jumpFrom(cc, rr, dirC[k], dirR[k], gIdx);
+            if (j == -1 || ws.isClosed(j)) continue;
+
+            int jc = j % cols;
+            int jr = j / cols;
+            float tentativeG = n.g + octileDist(jc - cc, jr - rr);
+            if (tentativeG < ws.gAt(j)) {
+                ws.setG(j, tentativeG, cur);
+                ws.push(j, tentativeG, tentativeG + hfun(jc, jr));
+            }
+        }
+    }
+
+    if (!found) return false;
+
+    // Jump points are in straight or diagonal lines from each other: fill in the tiles between
+    ws.cells.push_back(gIdx);
+    for (int cur = gIdx; ws.parentOf(cur) != -1; cur = ws.parentOf(cur)) {
+        int par = ws.parentOf(cur);
+        int c = cur % cols, r = cur / cols;
+        int pc = par % cols, pr = par / cols;
+        int sx = (pc > c) - (pc < c);
+        int sy = (pr > r) - (pr < r);
+        while (c != pc || r != pr) {
+            c += sx;
+            r += sy;
+            ws.cells.push_back(r * cols + c);
+        }
+    }
+    std::reverse(ws.cells.begin(), ws.cells.end());
+    return true;
+}
+
+// -----------------------------------------------------------
+// HPA*: chunk graph build + queries
+// -----------------------------------------------------------
+
+void Game::rebuildNavData() {
+    const int cs = cfg::NavClusterSize;
+    nav.cols = map.cols;
+    nav.rows = map.rows;
+    nav.ccols = (map.cols + cs - 1) / cs;
+    nav.crows = (map.rows + cs - 1) / cs;
+
+    const int count = nav.ccols * nav.crows;
+    nav.clusters.assign(count, NavCluster{});
+    nav.eastPairs.assign(count, std::vector<int>{});
+    nav.southPairs.assign(count, std::vector<int>{});
+    nav.slot.assign(map.cols * map.rows, -1);
+    nav.localDist.assign(cs * cs, -1.0f);
+    nav.localMoves.assign(cs * cs, 0);
+    nav.localSlot.assign(cs * cs, -1);
+    nav.localQueue[0].resize(cs * cs * 4);
+    nav.localQueue[1].resize(cs * cs * 4);
+
+    for (int k = 0; k < count; ++k) rebuildNavBorders(k);
+    for (int k = 0; k < count; ++k) rebuildNavCluster(k);
+    rebuildNavComponents();
+    rebuildClearance();
+
+    ++navVersion;
+}
+
+// A painted tile can only change its own chunk's interior and the borders it
+// shares with its four neighbours, so that is all we redo.
+void Game::onNavTileChanged(int c, int r) {
+    if (nav.clusters.empty() || !inBoundsTile(c, r)) return;
+
+    const int cs = cfg::NavClusterSize;
+    const int cx = c / cs;
+    const int cy = r / cs;
+    const int k = cy * nav.ccols + cx;
+
+    rebuildNavBorders(k);
+    if (cx > 0) rebuildNavBorders(k - 1);
+    if (cy > 0) rebuildNavBorders(k - nav.ccols);
+
+    rebuildNavCluster(k);
+    if (cx > 0)              rebuildNavCluster(k - 1);
+    if (cx < nav.ccols - 1)  rebuildNavCluster(k + 1);
+    if (cy > 0)              rebuildNavCluster(k - nav.ccols);
+    if (cy < nav.crows - 1)  rebuildNavCluster(k + nav.ccols);
+    updateNavComponents(c, r);
+    updateClearance(c, r);
+
+    ++navVersion;
+}
+
+void Game::rebuildNavComponents() {
+    const int count = map.cols * map.rows;
+    navComp.assign(count, -1);
+    navCompSize.clear();
+    navMainComp = -1;
+
+    for (int i = 0; i < count; ++i) {
+        if (navComp[i] >= 0 || !isNavWalkable(i % map.cols, i / map.cols)) continue;
+        navCompSize.push_back(0);
+        floodNavComponent(i, (int)navCompSize.size() - 1);
+    }
+    for (int l = 0; l < (int)navCompSize.size(); ++l) {
+        if (navMainComp < 0 || navCompSize[l] > navCompSize[navMainComp]) navMainComp = l;
+    }
+}
+
+// Opening a tile can only merge the components around it, and blocking one can
+// only split its own, so floods are limited to the regions actually affected.
+void Game::updateNavComponents(int c, int r) {
+    if ((int)navComp.size() != map.cols * map.rows) return;
+    const int idx = r * map.cols + c;
+    const int dC[4] = { 1,-1,0,0 };
+    const int dR[4] = { 0,0,1,-1 };
+
+    if (isNavWalkable(c, r)) {
+        if (navComp[idx] >= 0) return;
+
+        // Join the biggest neighbouring component and pull any others into it
+        int keep = -1;
+        for (int k = 0; k < 4; ++k) {
+            int l = navComponentAt(c + dC[k], r + dR[k]);
+            if (l >= 0 && (keep < 0 || navCompSize[l] > navCompSize[keep])) keep = l;
+        }
+        if (keep < 0) {
+            navCompSize.push_back(0);
+            keep = (int)navCompSize.size() - 1;
+        }
+        navComp[idx] = keep;
+        ++navCompSize[keep];
+        for (int k = 0; k < 4; ++k) {
+            int l = navComponentAt(c + dC[k], r + dR[k]);
+            if (l >= 0 && l != keep) floodNavComponent((r + dR[k]) * map.cols + c + dC[k], keep);
+        }
+    }
+    else {
+        if (navComp[idx] < 0) return;
+        --navCompSize[navComp[idx]];
+        navComp[idx] = -1;
+
+        // Walk the 8 tiles around it: if the open side tiles all sit in one unbroken
+        // run, they still touch each other and nothing can have split off.
+        const int ringC[8] = { 0, 1, 1, 1, 0,-1,-1,-1 };
+        const int ringR[8] = { -1,-1, 0, 1, 1, 1, 0,-1 };
+        int start = 0;
+        while (start < 8 && isNavWalkable(c + ringC[start], r + ringR[start])) ++start;
+        int runs = 0;
+        bool inRun = false, runHasSide = false;
+        for (int i = 1; i <= 8; ++i) {
+            int k = (start + i) % 8;
+            bool open = isNavWalkable(c + ringC[k], r + ringR[k]);
+            if (open) {
+                inRun = true;
+                if ((k & 1) == 0) runHasSide = true;
+            }
+            else if (inRun) {
+                runs += runHasSide ? 1 : 0;
+                inRun = runHasSide = false;
+            }
+        }
+        if (inRun && runHasSide) ++runs;   // whole ring open (start == 8)
+
+        // Each side gets a fresh label unless an earlier side's flood already reached it
+        const int firstNew = (int)navCompSize.size();
+        for (int k = 0; k < 4 && runs > 1; ++k) {
+            int nc = c + dC[k];
+            int nr = r + dR[k];
+            if (!isNavWalkable(nc, nr)) continue;
+            if (navComp[nr * map.cols + nc] >= firstNew) continue;
+            navCompSize.push_back(0);
+            floodNavComponent(nr * map.cols + nc, (int)navCompSize.size() - 1);
+        }
+    }
+
+    navMainComp = -1;
+    for (int l = 0; l < (int)navCompSize.size(); ++l) {
+        if (navMainComp < 0 || navCompSize[l] > navCompSize[navMainComp]) navMainComp = l;
+    }
+}
+
+void Game::floodNavComponent(int startCell, int label) {
+    const int cols = map.cols;
+    std::vector<int>& q = navCompQueue;
+    q.clear();
+
+    auto claim = [&](int i) {
+        if (navComp[i] >= 0) --navCompSize[navComp[i]];
+        navComp[i] = label;
+        ++navCompSize[label];
+        q.push_back(i);
+        };
+    claim(startCell);
+
+    const int dC[4] = { 1,-1,0,0 };
+    const int dR[4] = { 0,0,1,-1 };
+    for (size_t head = 0; head < q.size(); ++head) {
+        int cc = q[head] % cols;
+        int rr = q[head] / cols;
+        for (int k = 0; k < 4; ++k) {
+            int nc = cc + dC[k];
+            int nr = rr + dR[k];
+            if (!isNavWalkable(nc, nr)) continue;
+            if (navComp[nr * cols + nc] == label) continue;
+            claim(nr * cols + nc);
+        }
+    }
+}
+
+int Game::navComponentAt(int c, int r) const {
+    if (!inBoundsTile(c, r) || navComp.empty()) return -1;
+    return navComp[r * map.cols + c];
+}
+
+void Game::rebuildClearance() {
+    navClearance.assign(map.cols * map.rows, 0);
+    clearancePass(0, 0, map.cols - 1, map.rows - 1);
+}
+
+// Nothing further than the cap from the edit can change (it'd stay capped),
+// so redoing that window against the untouched tiles around it is exact.
+void Game::updateClearance(int c, int r) {
+    if ((int)navClearance.size() != map.cols * map.rows) return;
+    const int k = cfg::ClearanceCap;
+    clearancePass(std::max(0, c - k), std::max(0, r - k),
+        std::min(map.cols - 1, c + k), std::min(map.rows - 1, r + k));
+}
+
+// Two-pass chessboard distance transform over the window; tiles just outside it
+// keep their values and act as seeds.
+void Game::clearancePass(int c0, int r0, int c1, int r1) {
+    const int cols = map.cols;
+    const int cap = cfg::ClearanceCap;
+
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c)
+            navClearance[r * cols + c] = isNavWalkable(c, r) ? (uint8_t)cap : 0;
+
+    auto relax = [&](int c, int r, int dc, int dr) {
+        uint8_t& v = navClearance[r * cols + c];
+        int nb = clearanceAt(c + dc, r + dr) + 1;
+        if (nb < v) v = (uint8_t)nb;
+        };
+
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c) {
+            if (navClearance[r * cols + c] == 0) continue;
+            relax(c, r, -1, 0); relax(c, r, -1, -1); relax(c, r, 0, -1); relax(c, r, 1, -1);
+        }
+    for (int r = r1; r >= r0; --r)
+        for (int c = c1; c >= c0; --c) {
+            if (navClearance[r * cols + c] == 0) continue;
+            relax(c, r, 1, 0); relax(c, r, 1, 1); relax(c, r, 0, 1); relax(c, r, -1, 1);
+        }
+}
+
+int Game::clearanceAt(int c, int r) const {
+    if (!inBoundsTile(c, r) || navClearance.empty()) return 0;
+    return navClearance[r * map.cols + c];
+}
+
+bool Game::navOpen(int c, int r) const {
+    if (!isNavWalkable(c, r)) return false;
+    if (navMinClear <= 1 || navClearance[r * map.cols + c] >= navMinClear) return true;
+
+    // Let the search leave a tight start and reach a goal tucked against a wall
+    return std::max(std::abs(c - navClearSC), std::abs(r - navClearSR)) < navMinClear ||
+        std::max(std::abs(c - navClearGC), std::abs(r - navClearGR)) < navMinClear;
+}
+
+bool Game::navWideReachable(int fromIdx, int toIdx) const {
+    const int cols = map.cols;
+    const int count = cols * map.rows;
+    const int minClear = pathMinClearance;
+
+    if ((int)navWideComp.size() != count || navWideVersion != navVersion || navWideMin != minClear) {
+        navWideComp.assign(count, -1);
+        navWideVersion = navVersion;
+        navWideMin = minClear;
+
+        std::vector<int>& q = pathWs.cells;
+        int label = 0;
+        for (int i = 0; i < count; ++i) {
+            if (navWideComp[i] >= 0 || navClearance[i] < minClear) continue;
+            q.clear();
+            q.push_back(i);
+            navWideComp[i] = label;
+            for (size_t head = 0; head < q.size(); ++head) {
+                int cc = q[head] % cols;
+                int rr = q[head] / cols;
+                for (int k = 0; k < 4; ++k) {
+                    int nc = cc + NavDC[k];
+                    int nr = rr + NavDR[k];
+                    if (clearanceAt(nc, nr) < minClear) continue;
+                    int ni = nr * cols + nc;
+                    if (navWideComp[ni] >= 0) continue;
+                    navWideComp[ni] = label;
+                    q.push_back(ni);
+                }
+            }
+            ++label;
+        }
+        q.clear();
+    }
+
+    // Any roomy tile in the start's exempt zone sharing a label with one in the goal's
+    const int rad = minClear - 1;
+    auto labelsAround = [&](int idx, int* out) {
+        int n = 0;
+        for (int dr = -rad; dr <= rad; ++dr)
+            for (int dc = -rad; dc <= rad; ++dc) {
+                int c = idx % cols + dc, r = idx / cols + dr;
+                if (!inBoundsTile(c, r)) continue;
+                int l = navWideComp[r * cols + c];
+                if (l >= 0 && n < 64) out[n++] = l;
+            }
+        return n;
+        };
+    int a[64], b[64];
+    int na = labelsAround(fromIdx, a);
+    int nb = labelsAround(toIdx, b);
+    for (int i = 0; i < na; ++i)
+        for (int j = 0; j < nb; ++j)
+            if (a[i] == b[j]) return true;
+    return false;
+}
+
+// Entrances on chunk k's east and south borders. Open runs shorter than 6 get one
+// entrance in the middle, longer ones one at each end.
+void Game::rebuildNavBorders(int k) {
+    const int cols = map.cols;
+    const int cx = k % nav.ccols;
+    const int cy = k / nav.ccols;
+    int c0, r0, c1, r1;
+    nav.bounds(k, c0, r0, c1, r1);
+
+    auto open = [&](int x, int y) { return isNavWalkable(x, y); };
+
+    // Walk one border: (ax,ay) steps along our edge, (bx,by) is the matching cell across it.
+    auto scan = [&](std::vector<int>& out, int ax, int ay, int bx, int by, int stepX, int stepY, int len) {
+        out.clear();
+        int runStart = -1;
+        for (int i = 0; i <= len; ++i) {
+            bool ok = i < len &&
+                open(ax + stepX * i, ay + stepY * i) &&
+                open(bx + stepX * i, by + stepY * i);
+            if (ok && runStart < 0) runStart = i;
+            if (ok || runStart < 0) continue;
+
+            int runEnd = i - 1;
+            int picks[2] = { (runStart + runEnd) / 2, -1 };
+            if (runEnd - runStart + 1 >= 6) {
+                picks[0] = runStart;
+                picks[1] = runEnd;
+            }
+            for (int p : picks) {
+                if (p < 0) continue;
+                out.push_back((ay + stepY * p) * cols + (ax + stepX * p));
+                out.push_back((by + stepY * p) * cols + (bx + stepX * p));
+            }
+            runStart = -1;
+        }
+        };
+
+    if (cx < nav.ccols - 1) scan(nav.eastPairs[k], c1, r0, c1 + 1, r0, 0, 1, r1 - r0 + 1);
+    else nav.eastPairs[k].clear();
+
+    if (cy < nav.crows - 1) scan(nav.southPairs[k], c0, r1, c0, r1 + 1, 1, 0, c1 - c0 + 1);
+    else nav.southPairs[k].clear();
+}
+
+// Collect chunk k's entrances from its four borders, then Dijkstra from each one
+// to fill the distance table.
+void Game::rebuildNavCluster(int k) {
+    NavCluster& cl = nav.clusters[k];
+    for (int cell : cl.cells) nav.slot[cell] = -1;
+    cl.cells.clear();
+    cl.partner.clear();
+
+    auto addEntrance = [&](int ours, int theirs) {
+        int s = nav.slot[ours];
+        if (s < 0) {
+            if ((int)cl.cells.size() >= NavGraph::MaxEntrances) return;
+            s = (int)cl.cells.size();
+            nav.slot[ours] = s;
+            cl.cells.push_back(ours);
+            cl.partner.push_back(-1);
+            cl.partner.push_back(-1);
+        }
+        int* p = &cl.partner[s * 2];
+        if (p[0] < 0) p[0] = theirs;
+        else if (p[0] != theirs) p[1] = theirs;
+        };
+
+    const int cx = k % nav.ccols;
+    const int cy = k / nav.ccols;
+    const std::vector<int>& east = nav.eastPairs[k];
+    const std::vector<int>& south = nav.southPairs[k];
+    for (size_t i = 0; i + 1 < east.size(); i += 2)  addEntrance(east[i], east[i + 1]);
+    for (size_t i = 0; i + 1 < south.size(); i += 2) addEntrance(south[i], south[i + 1]);
+    if (cx > 0) {
+        const std::vector<int>& w = nav.eastPairs[k - 1];
+        for (size_t i = 0; i + 1 < w.size(); i += 2) addEntrance(w[i + 1], w[i]);
+    }
+    if (cy > 0) {
+        const std::vector<int>& n = nav.southPairs[k - nav.ccols];
+        for (size_t i = 0; i + 1 < n.size(); i += 2) addEntrance(n[i + 1], n[i]);
+    }
+
+    const int n = (int)cl.cells.size();
+    cl.dist.assign(n * n, -1.0f);
+    // Steps are legal both ways, so the table is symmetric: entrance i only
+    // searches until the ones after it are settled and fills both halves
+    std::vector<float> row;
+    navClusterMoves(k);   // shared by every entrance's search below
+    for (int i = 0; i + 1 < n; ++i) {
+        navClusterDijkstra(k, cl.cells[i], row, i + 1);
+        for (int j = i + 1; j < n; ++j) {
+            cl.dist[i * n + j] = row[j];
+            cl.dist[j * n + i] = row[j];
+        }
+    }
+    for (int i = 0; i < n; ++i) cl.dist[i * n + i] = 0.0f;
+}
+
+// Which of the 8 steps each cell of chunk k may take without leaving the chunk,
+// and which cells are its entrances, into nav.localMoves/localSlot for
+// navClusterDijkstra
+void Game::navClusterMoves(int k) const {
+    const int cs = cfg::NavClusterSize;
+    int c0, r0, c1, r1;
+    nav.bounds(k, c0, r0, c1, r1);
+    const int w = c1 - c0 + 1;
+    const int h = r1 - r0 + 1;
+
+    std::fill(nav.localMoves.begin(), nav.localMoves.end(), uint8_t(0));
+    std::fill(nav.localSlot.begin(), nav.localSlot.end(), int8_t(-1));
+    for (int ly = 0; ly < h; ++ly) {
+        for (int lx = 0; lx < w; ++lx) {
+            nav.localSlot[ly * cs + lx] = (int8_t)nav.slot[(r0 + ly) * map.cols + (c0 + lx)];
+            if (!isNavWalkable(c0 + lx, r0 + ly)) continue;
+            uint8_t moves = 0;
+            for (int m = 0; m < 8; ++m) {
+                int nx = lx + NavDC[m];
+                int ny = ly + NavDR[m];
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                if (navStepOk(c0 + lx, r0 + ly, NavDC[m], NavDR[m])) moves |= uint8_t(1u << m);
+            }
+            nav.localMoves[ly * cs + lx] = moves;
+        }
+    }
+}
+
+// Walking distance from srcCell to each entrance of chunk k, staying inside the chunk.
+// navClusterMoves(k) must have filled nav.localMoves/localSlot. Entrances below slot
+// needFrom may be left unsettled (-1 or an overestimate).
+void Game::navClusterDijkstra(int k, int srcCell, std::vector<float>& out, int needFrom) const {
+    const int cs = cfg::NavClusterSize;
+    const int cols = map.cols;
+    int c0, r0, c1, r1;
+    nav.bounds(k, c0, r0, c1, r1);
+
+    // Work in chunk-local indices (lx + ly * cs) so we never divide by map width.
+    // There are only two step costs, and cells come out in distance order, so
+    // each cost's FIFO queue is already sorted: the nearer of the two heads is
+    // the next cell, no heap needed. Stale entries are skipped on the way out.
+    // A cell is pushed at most once per neighbour, 4 per queue, so the queues
+    // are fixed arrays written by index.
+    float* dist = nav.localDist.data();
+    std::fill(nav.localDist.begin(), nav.localDist.end(), -1.0f);
+    std::pair<float, int>* q[2] = { nav.localQueue[0].data(), nav.localQueue[1].data() };
+    int head[2] = { 0, 0 }, tail[2] = { 0, 0 };
+    const uint8_t* movesOf = nav.localMoves.data();
+    const int8_t* slotOf = nav.localSlot.data();
+
+    // Only the entrances' distances are wanted: stop once the last one is settled
+    int entrancesLeft = (int)nav.clusters[k].cells.size() - needFrom;
+    if (entrancesLeft <= 0) entrancesLeft = -1;   // nothing wanted; never hits 0
+
+    int src = (srcCell / cols - r0) * cs + (srcCell % cols - c0);
+    dist[src] = 0.0f;
+    q[0][tail[0]++] = { 0.0f, src };
+    for (;;) {
+        const bool has0 = head[0] < tail[0], has1 = head[1] < tail[1];
+        if (!has0 && !has1) break;
+        const int qi = (!has0 || (has1 && q[1][head[1]].first < q[0][head[0]].first)) ? 1 : 0;
+        const float d = q[qi][head[qi]].first;
+        const int li = q[qi][head[qi]].second;
+        ++head[qi];
+        if (d > dist[li]) continue;   // stale
+        if (slotOf[li] >= needFrom && --entrancesLeft == 0) break;
+
+        const int moves = movesOf[li];
+        for (int m = 0; m < 8; ++m) {
+            if (!(moves & (1 << m))) continue;
+            const int ni = li + NavDR[m] * cs + NavDC[m];
+            const float nd = d + NavStepCost[m];
+            if (dist[ni] >= 0.0f && dist[ni] <= nd) continue;
+            dist[ni] = nd;
+            const int qn = m < 4 ? 0 : 1;
+            q[qn][tail[qn]++] = { nd, ni };
+        }
+    }
+
+    const NavCluster& cl = nav.clusters[k];
+    out.resize(cl.cells.size());
+    for (size_t i = 0; i < cl.cells.size(); ++i) {
+        int cell = cl.cells[i];
+        out[i] = dist[(cell / cols - r0) * cs + (cell % cols - c0)];
+    }
+}
+
+// A* over entrances. Start and goal join the graph through a BFS in their own chunk.
+bool Game::searchAbstract(int sIdx, int gIdx) const {
+    const int cols = map.cols;
+    nav.route.clear();
+
+    const int ks = nav.clusterOf(sIdx);
+    const int kg = nav.clusterOf(gIdx);
+
+    // Same chunk: most of the time the answer never leaves it
+    if (ks == kg) {
+        int c0, r0, c1, r1;
+        nav.bounds(ks, c0, r0, c1, r1);
+        if (searchGridPathIn(sIdx, gIdx, c0, r0, c1, r1)) {
+            nav.route.push_back(sIdx);
+            nav.route.push_back(gIdx);
+            return true;
+        }
+    }
+
+    navClusterMoves(ks);
+    navClusterDijkstra(ks, sIdx, nav.startDist);
+    navClusterMoves(kg);
+    navClusterDijkstra(kg, gIdx, nav.goalDist);
+
+    const int gc = gIdx % cols;
+    const int gr = gIdx / cols;
+    auto hfun = [&](int cell) {
+        return cfg::NavRouteHeuristicWeight * octileDist(cell % cols - gc, cell / cols - gr);
+        };
+
+    // Node ids: entrances first, then the start and goal as two extra nodes
+    const int M = NavGraph::MaxEntrances;
+    const int startId = (int)nav.clusters.size() * M;
+    const int goalId = startId + 1;
+    auto cellOf = [&](int id) {
+        if (id == startId) return sIdx;
+        if (id == goalId) return gIdx;
+        return nav.clusters[id / M].cells[id % M];
+        };
+    auto idOf = [&](int cell) { return nav.clusterOf(cell) * M + nav.slot[cell]; };
+
+    PathWorkspace& ws = navWs;
+    ws.begin(goalId + 1);
+    ws.setG(startId, 0.0f, -1);
+    ws.push(startId, 0.0f, hfun(sIdx));
+
+    bool found = false;
+    while (!ws.open.empty()) {
+        PathWorkspace::OpenNode n = ws.pop();
+        int cur = n.idx;
+        if (ws.isClosed(cur) || n.g > ws.gAt(cur)) continue; // stale heap entry
+        if (cur == goalId) {
+            found = true;
+            break;
+        }
+        ws.close(cur);
+
+        auto relax = [&](int to, int toCell, float cost) {
+            if (ws.isClosed(to)) return;
+            float tentativeG = n.g + cost;
+            if (tentativeG < ws.gAt(to)) {
+                ws.setG(to, tentativeG, cur);
+                ws.push(to, tentativeG, tentativeG + hfun(toCell));
+            }
+            };
+
+        if (cur == startId) {
+            const NavCluster& cl = nav.clusters[ks];
+            for (int j = 0; j < (int)cl.cells.size(); ++j) {
+                if (nav.startDist[j] >= 0.0f) relax(ks * M + j, cl.cells[j], nav.startDist[j]);
+            }
+            continue;
+        }
+
+        int k = cur / M;
+        int s = cur % M;
+        const NavCluster& cl = nav.clusters[k];
+        const int cn = (int)cl.cells.size();
+        for (int j = 0; j < cn; ++j) {
+            float d = cl.dist[s * cn + j];
+            if (j != s && d >= 0.0f) relax(k * M + j, cl.cells[j], d);
+        }
+        for (int p = 0; p < 2; ++p) {
+            int pc = cl.partner[s * 2 + p];
+            if (pc >= 0) relax(idOf(pc), pc, 1.0f);
+        }
+        if (k == kg && nav.goalDist[s] >= 0.0f) relax(goalId, gIdx, nav.goalDist[s]);
+    }
+
+    pathWs.expanded = ws.expanded;
+    if (!found) return false;
+
+    for (int cur = goalId; cur != -1; cur = ws.parentOf(cur)) {
+        int cell = cellOf(cur);
+        if (nav.route.empty() || nav.route.back() != cell) nav.route.push_back(cell);
+    }
+    std::reverse(nav.route.begin(), nav.route.end());
+    return true;
+}
+
+// One route leg -> tiles (excluding fromCell). Legs either step across a border
+// or stay inside one chunk, so the tile search is boxed to that chunk.
+bool Game::refineNavLeg(int fromCell, int toCell, std::vector<int>& out) const {
+    const int cols = map.cols;
+    int dist = std::abs(fromCell % cols - toCell % cols) + std::abs(fromCell / cols - toCell / cols);
+    if (dist == 1) {
+        out.push_back(toCell);
+        return true;
+    }
+
+    int c0, r0, c1, r1;
+    nav.bounds(nav.clusterOf(fromCell), c0, r0, c1, r1);
+    if (!searchGridPathIn(fromCell, toCell, c0, r0, c1, r1)) return false;
+    out.insert(out.end(), pathWs.cells.begin() + 1, pathWs.cells.end());
+    return true;
+}
+
+bool Game::searchHierarchical(int sIdx, int gIdx) const {
+    if (!searchAbstract(sIdx, gIdx)) return false;
+
+    int expanded = pathWs.expanded;
+    std::vector<int>& cells = nav.legCells;
+    cells.clear();
+    cells.push_back(nav.route[0]);
+    for (size_t i = 0; i + 1 < nav.route.size(); ++i) {
+        if (!refineNavLeg(nav.route[i], nav.route[i + 1], cells)) return false;
+        expanded += pathWs.expanded;
+    }
+    pathWs.cells.swap(cells);
+    pathWs.expanded = expanded;
+    return true;
+}
+
+// Turn the next few route legs into a.path. False when the route is used up
+// or a leg no longer connects (map painted since); caller clears the path.
+bool Game::refineNavLegs(Actor& a) const {
+    const int last = (int)a.navRoute.size() - 1;
+    if (a.navRouteIndex < 0 || a.navRouteIndex >= last) return false;
+
+    // The batch starts at the entrance we're standing on so the pull can see past it;
+    // after the first batch that point is already behind us and gets dropped.
+    const bool first = a.navRouteIndex == 0;
+    std::vector<int>& cells = nav.legCells;
+    cells.clear();
+    cells.push_back(a.navRoute[a.navRouteIndex]);
+
+    while (a.navRouteIndex < last && (int)cells.size() < cfg::NavRefineTiles) {
+        if (!refineNavLeg(a.navRoute[a.navRouteIndex], a.navRoute[a.navRouteIndex + 1], cells)) {
+            return false;
+        }
+        ++a.navRouteIndex;
+    }
+
+    stringPull(cells, a.path);
+    if (!first && !a.path.empty()) a.path.erase(a.path.begin());
+    a.pathIndex = a.path.empty() ? -1 : 0;
+    return !a.path.empty();
+}
+
+// -----------------------------------------------------------
+// Flow fields
+// -----------------------------------------------------------
+
+const FlowField& Game::flowFieldTo(int goalCell) {
+    ++flowUseStamp;
+    for (FlowField& f : flowFields) {
+        if (f.goalCell == goalCell && f.navVersion == navVersion) {
+            f.lastUsed = flowUseStamp;
+            ++flowHits;
+            return f;
+        }
+    }
+
+    // Miss: reuse a stale or the least recently used slot
+    FlowField* slot = nullptr;
+    if ((int)flowFields.size() < cfg::FlowFieldCacheSize) {
+        flowFields.emplace_back();
+        slot = &flowFields.back();
+    }
+    else {
+        slot = &flowFields[0];
+        for (FlowField& f : flowFields) {
+            if (f.navVersion != navVersion) { slot = &f; break; }
+            if (f.lastUsed < slot->lastUsed) slot = &f;
+        }
+    }
+
+    buildFlowField(*slot, goalCell);
+    slot->lastUsed = flowUseStamp;
+    ++flowBuilds;
+    return *slot;
+}
+
+// Integration field: octile walking distance from every reachable tile to the
+// goal (NavStepCost, same corner rules as the path search).
+void Game::buildFlowField(FlowField& f, int goalCell) const {
+    const int cols = map.cols;
+    const int count = cols * map.rows;
+
+    f.goalCell = goalCell;
+    f.navVersion = navVersion;
+    f.dist.assign(count, -1.0f);
+    if (goalCell < 0 || goalCell >= count) return;
+
+    // Dijkstra outwards from the goal on the path workspace. Corner rules are
+    // symmetric, so a step that's legal out of the goal is legal back into it.
+    PathWorkspace& ws = pathWs;
+    ws.begin(count);
+    ws.setG(goalCell, 0.0f, -1);
+    ws.push(goalCell, 0.0f, 0.0f);
+
+    while (!ws.open.empty()) {
+        PathWorkspace::OpenNode n = ws.pop();
+        int cur = n.idx;
+        if (ws.isClosed(cur) || n.g > ws.gAt(cur)) continue;
+        ws.close(cur);
+        f.dist[cur] = n.g;
+
+        int cc = cur % cols;
+        int rr = cur / cols;
+        for (int k = 0; k < 8; ++k) {
+            if (!navStepOk(cc, rr, NavDC[k], NavDR[k])) continue;
+            int ni = (rr + NavDR[k]) * cols + (cc + NavDC[k]);
+            if (ws.isClosed(ni)) continue;
+            float ng = n.g + NavStepCost[k];
+            if (ng < ws.gAt(ni)) {
+                ws.setG(ni, ng, cur);
+                ws.push(ni, ng, ng);
+            }
+        }
+    }
+}
+
+// Direction toward the lowest neighbouring tile. False when there is nothing to
+// follow (off the field, unreachable) or we're already within handoff range.
+bool Game::flowDirection(const FlowField& f, const Vec2& pos, Vec2& outDir) const {
+    const int cols = map.cols;
+    int c = int(pos.x / cfg::TileSize);
+    int r = int(pos.y / cfg::TileSize);
+    if (!inBoundsTile(c, r)) return false;
+
+    float here = f.dist[r * cols + c];
+    if (here < 0.0f || here <= (float)cfg::FlowHandoffTiles) return false;
+
+    int bestC = -1, bestR = -1;
+    float best = here;
+    for (int k = 0; k < 8; ++k) {
+        if (!navStepOk(c, r, NavDC[k], NavDR[k])) continue;
+        int nc = c + NavDC[k];
+        int nr = r + NavDR[k];
+        float d = f.dist[nr * cols + nc];
+        if (d >= 0.0f && d < best) {
+            best = d;
+            bestC = nc;
+            bestR = nr;
+        }
+    }
+    if (bestC < 0) return false;
+
+    SDL_FRect tr = tileRectWorld(bestC, bestR);
+    outDir = normalize(Vec2{ tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f } - pos);
+    return length(outDir) > 0.001f;
+}
+
+// -----------------------------------------------------------
+// Path cache
+// -----------------------------------------------------------
+
+bool Game::lookupPathCache(int sIdx, int gIdx) const {
+    if (!pathCacheEnabled) return false;
+
+    PathCacheEntry* exact = nullptr;
+    PathCacheEntry* suffix = nullptr;
+    size_t suffixAt = 0;
+    for (PathCacheEntry& e : pathCache) {
+        if (e.goalCell != gIdx || e.navVersion != navVersion) continue;
+        if (e.startCell == sIdx) { exact = &e; break; }
+        if (!suffix) {
+            auto it = std::find(e.cells.begin(), e.cells.end(), sIdx);
+            if (it != e.cells.end()) {
+                suffix = &e;
+                suffixAt = size_t(it - e.cells.begin());
+            }
+        }
+    }
+
+    PathCacheEntry* e = exact ? exact : suffix;
+    if (!e) {
+        ++pathCacheMisses;
+        return false;
+    }
+
+    e->lastUsed = ++pathCacheStamp;
+    pathWs.cells.assign(e->cells.begin() + (exact ? 0 : suffixAt), e->cells.end());
+    if (exact) ++pathCacheHits;
+    else ++pathCacheSuffixHits;
+    return true;
+}
+
+void Game::storePathCache(int sIdx, int gIdx) const {
+    if (!pathCacheEnabled || pathWs.cells.empty()) return;
+
+    PathCacheEntry* slot = nullptr;
+    if ((int)pathCache.size() < cfg::PathCacheSize) {
+        pathCache.emplace_back();
+        slot = &pathCache.back();
+    }
+    else {
+        slot = &pathCache[0];
+        for (PathCacheEntry& e : pathCache) {
+            if (e.navVersion != navVersion) { slot = &e; break; }
+            if (e.lastUsed < slot->lastUsed) slot = &e;
+        }
+    }
+
+    slot->startCell = sIdx;
+    slot->goalCell = gIdx;
+    slot->navVersion = navVersion;
+    slot->lastUsed = ++pathCacheStamp;
+    slot->cells.assign(pathWs.cells.begin(), pathWs.cells.end());
+}
+
+// The pre-heap A* (fresh vectors per call, linear scan for the best open node).
+// Only runBenchmarks calls this now, as the "before" column. Kept as it was:
+// 4-connected with unit steps, so it times the old search, not today's problem.
+bool Game::searchGridPathReference(int sIdx, int gIdx) const {
+    const int cols = map.cols;
+    const int count = cols * map.rows;
+    const int gc = gIdx % cols;
+    const int gr = gIdx / cols;
+
+    std::vector<float> gscore(count, 1e9f);
+    std::vector<float> fscore(count, 1e9f);
+    std::vector<int>   parent(count, -1);
+    std::vector<bool>  openFlag(count, false);
+    std::vector<bool>  closed(count, false);
+
+    auto hfun = [&](int c, int r) {
+        float dx = float(c - gc);
+        float dy = float(r - gr);
+        return std::sqrt(dx * dx + dy * dy);
+        };
+
+    struct Node {
+        int idx;
+        float f;
+    };
+
+    std::vector<Node> open;
+    gscore[sIdx] = 0.0f;
+    fscore[sIdx] = hfun(sIdx % cols, sIdx / cols);
+    open.push_back({ sIdx, fscore[sIdx] });
+    openFlag[sIdx] = true;
+
+    auto popBest = [&]() -> int {
+        int best = -1;
+        float bestF = 1e9f;
+        for (int i = 0; i < (int)open.size(); ++i) {
+            if (open[i].f < bestF) {
+                bestF = open[i].f;
+                best = i;
             }
         }
         if (best == -1) return -1;
@@ -3195,16 +5312,20 @@ bool Game::buildPath(const Vec2& start, const Vec2& goal, Actor& a) const {
     const int dC[4] = { 1,-1,0,0 };
     const int dR[4] = { 0,0,1,-1 };
 
-    int gIdx = -1;
+    pathWs.expanded = 0;
+    pathWs.cells.clear();
+
+    int found = -1;
     for (;;) {
         int cur = popBest();
         if (cur == -1) break;
-        if (cur == toIndex(gc, gr)) {
-            gIdx = cur;
+        if (cur == gIdx) {
+            found = cur;
             break;
         }
         if (closed[cur]) continue;
         closed[cur] = true;
+        pathWs.expanded++;
 
         int cc = cur % cols;
         int rr = cur / cols;
@@ -3214,10 +5335,9 @@ bool Game::buildPath(const Vec2& start, const Vec2& goal, Actor& a) const {
             if (!inBoundsTile(nc, nr)) continue;
             if (!isNavWalkable(nc, nr)) continue;
 
-            int ni = toIndex(nc, nr);
+            int ni = nr * cols + nc;
             if (closed[ni]) continue;
-            float cost = 1.0f;
-            float tentativeG = gscore[cur] + cost;
+            float tentativeG = gscore[cur] + 1.0f;
             if (tentativeG < gscore[ni]) {
                 gscore[ni] = tentativeG;
                 fscore[ni] = tentativeG + hfun(nc, nr);
@@ -3230,25 +5350,81 @@ bool Game::buildPath(const Vec2& start, const Vec2& goal, Actor& a) const {
         }
     }
 
-    if (gIdx == -1) {
-        a.path.clear();
-        a.pathIndex = -1;
+    if (found == -1) return false;
+    for (int cur = found; cur != -1; cur = parent[cur]) {
+        pathWs.cells.push_back(cur);
+    }
+    std::reverse(pathWs.cells.begin(), pathWs.cells.end());
+    return true;
+}
+
+bool Game::buildPath(const Vec2& start, const Vec2& goal, Actor& a) const {
+    const int cols = map.cols;
+
+    int sc = int(start.x / cfg::TileSize);
+    int sr = int(start.y / cfg::TileSize);
+    int gc = int(goal.x / cfg::TileSize);
+    int gr = int(goal.y / cfg::TileSize);
+
+    if (!inBoundsTile(sc, sr) || !inBoundsTile(gc, gr)) {
+        return false;
+    }
+    if (!isNavWalkable(sc, sr) || !isNavWalkable(gc, gr)) {
+        return false;
+    }
+    // Sealed rooms, islands, tree pockets: no search would ever get there
+    if (!navReachable(sr * cols + sc, gr * cols + gc)) {
+        clearPath(a);
         return false;
     }
 
-    std::vector<Vec2> rev;
-    int cur = gIdx;
-    while (cur != -1) {
-        int c = cur % cols;
-        int r = cur / cols;
-        SDL_FRect tr = tileRectWorld(c, r);
-        rev.push_back(Vec2{ tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f });
-        cur = parent[cur];
+    // HPA*: keep the entrance route, only the first few legs become tiles now
+    if (pathMode == PathMode::Hierarchical) {
+        clearPath(a);
+        if (!searchAbstract(sr * cols + sc, gr * cols + gc)) return false;
+        a.navRoute.assign(nav.route.begin(), nav.route.end());
+        a.navRouteIndex = 0;
+        if (!refineNavLegs(a)) {
+            clearPath(a);
+            return false;
+        }
+        if (a.path.size() > 1 && navLineClear(start, a.path[1], cfg::PawnSize * 0.75f)) {
+            a.pathIndex = 1;
+        }
+        a.repathTimer = 0.0f;
+        return true;
     }
-    std::reverse(rev.begin(), rev.end());
 
-    a.path = rev;
-    a.pathIndex = rev.empty() ? -1 : 0;
+    const int sIdx = sr * cols + sc;
+    const int gIdx = gr * cols + gc;
+    if (!lookupPathCache(sIdx, gIdx)) {
+        // Keep off walls and trunks where there's room; squeeze only if that fails
+        navClearSC = sc; navClearSR = sr;
+        navClearGC = gc; navClearGR = gr;
+        navMinClear = navWideReachable(sIdx, gIdx) ? pathMinClearance : 1;
+        bool found = searchPath(sIdx, gIdx);
+        if (!found && navMinClear > 1) {
+            navMinClear = 1;
+            found = searchPath(sIdx, gIdx);
+        }
+        navMinClear = 1;
+        if (!found) {
+            clearPath(a);
+            return false;
+        }
+        storePathCache(sIdx, gIdx);
+    }
+    a.navRoute.clear();
+    a.navRouteIndex = -1;
+
+    // Only the turning points survive; a.path keeps its capacity between repaths.
+    stringPull(pathWs.cells, a.path);
+
+    a.pathIndex = a.path.empty() ? -1 : 0;
+    // Don't walk back to our own tile centre when the next corner is already in view.
+    if (a.path.size() > 1 && navLineClear(start, a.path[1], cfg::PawnSize * 0.75f)) {
+        a.pathIndex = 1;
+    }
     a.repathTimer = 0.0f;
     return true;
 }
@@ -3256,6 +5432,209 @@ bool Game::buildPath(const Vec2& start, const Vec2& goal, Actor& a) const {
 void Game::clearPath(Actor& a) const {
     a.path.clear();
     a.pathIndex = -1;
+    a.navRoute.clear();
+    a.navRouteIndex = -1;
+    a.pathTicket = 0;
+    a.pathGoalCell = -1;
+}
+
+// -----------------------------------------------------------
+// Path repair after paint edits
+// -----------------------------------------------------------
+// Only paths that actually step on the painted tile are touched. Each one gets a
+// detour from the tile before the cut to the first open tile after it, searched
+// inside a small box, and spliced in. Only if that fails does the actor go back
+// through the request queue. (Opening a tile never breaks a path, so erasing
+// walls needs nothing here; repathTimer picks up any shortcut later.)
+
+int Game::repairPathsAfterBlock(int c, int r, int& requeued) {
+    const int blocked = r * map.cols + c;
+    int repaired = 0;
+    requeued = 0;
+
+    for (Actor& a : actors) {
+        if (!a.alive() || a.path.empty() || a.pathIndex < 0) continue;
+        if (firstBlockedSegment(a, blocked) < 0) continue;
+
+        if (repairPath(a, blocked)) {
+            ++repaired;
+        }
+        else {
+            Vec2 goal = a.navRoute.empty() ? a.path.back()
+                : tileCenterOf(a.navRoute.back());
+            clearPath(a);
+            requestPath(a, goal);
+            ++requeued;
+        }
+    }
+    return repaired;
+}
+
+// Waypoints are string-pulled, so the new block can sit between two of them.
+// Segment k runs path[k-1] -> path[k] (from the actor itself for k == pathIndex);
+// only segments whose pawn-wide strip reaches the blocked tile get a LOS walk.
+int Game::firstBlockedSegment(const Actor& a, int blockedCell) const {
+    const float ts = cfg::TileSize;
+    const float radius = cfg::PawnSize * 0.75f;
+    const float bx0 = (blockedCell % map.cols) * ts - radius;
+    const float by0 = (blockedCell / map.cols) * ts - radius;
+    const float bx1 = bx0 + ts + 2.0f * radius;
+    const float by1 = by0 + ts + 2.0f * radius;
+
+    for (int k = a.pathIndex; k < (int)a.path.size(); ++k) {
+        const Vec2& p0 = (k == a.pathIndex) ? a.pos : a.path[k - 1];
+        const Vec2& p1 = a.path[k];
+        if (std::max(p0.x, p1.x) < bx0 || std::min(p0.x, p1.x) > bx1 ||
+            std::max(p0.y, p1.y) < by0 || std::min(p0.y, p1.y) > by1) {
+            continue;
+        }
+        if (!navLineClear(p0, p1, radius)) return k;
+    }
+    return -1;
+}
+
+bool Game::repairPath(Actor& a, int blockedCell) {
+    const int cols = map.cols;
+
+    // A pulled path can pass the same tile on two separate segments, so
+    // patch, rescan, and give up after a few rounds.
+    for (int pass = 0; pass < 3; ++pass) {
+        const int n = (int)a.path.size();
+        int cut = firstBlockedSegment(a, blockedCell);
+        if (cut < 0) return true;
+
+        // Rejoin at the first waypoint still on open ground; none left means the goal itself is gone
+        int rejoin = cut;
+        while (rejoin < n && tileIndexAt(a.path[rejoin]) >= 0 &&
+            !isNavWalkable(int(a.path[rejoin].x / cfg::TileSize),
+                int(a.path[rejoin].y / cfg::TileSize))) {
+            ++rejoin;
+        }
+        if (rejoin >= n) return false;
+
+        // Leave from the waypoint before the cut, or from where we stand
+        int from = (cut > a.pathIndex) ? tileIndexAt(a.path[cut - 1]) : tileIndexAt(a.pos);
+        int to = tileIndexAt(a.path[rejoin]);
+        if (from < 0 || to < 0) return false;
+
+        const int m = cfg::PathRepairMarginTiles;
+        int c0 = std::max(0, std::min(from % cols, to % cols) - m);
+        int c1 = std::min(cols - 1, std::max(from % cols, to % cols) + m);
+        int r0 = std::max(0, std::min(from / cols, to / cols) - m);
+        int r1 = std::min(map.rows - 1, std::max(from / cols, to / cols) + m);
+        if (!searchGridPathIn(from, to, c0, r0, c1, r1)) return false;
+
+        std::vector<Vec2> detour;
+        stringPull(pathWs.cells, detour);
+
+        // path[..cut-1] + detour (minus its first point) + path[rejoin+1..]
+        std::vector<Vec2> patched;
+        patched.reserve(n + detour.size());
+        patched.insert(patched.end(), a.path.begin(), a.path.begin() + cut);
+        patched.insert(patched.end(), detour.begin() + 1, detour.end());
+        patched.insert(patched.end(), a.path.begin() + rejoin + 1, a.path.end());
+
+        a.path.swap(patched);
+        if (a.pathIndex >= (int)a.path.size()) a.pathIndex = (int)a.path.size() - 1;
+        if (a.path.empty()) return false;
+    }
+    return firstBlockedSegment(a, blockedCell) < 0;
+}
+
+// -----------------------------------------------------------
+// Path request queue
+// -----------------------------------------------------------
+
+static bool pathRequestLater(const PathRequest& a, const PathRequest& b) {
+    return a.priority > b.priority;
+}
+
+void Game::requestPath(Actor& a, const Vec2& goal) {
+    if (&a < actors.data() || &a >= actors.data() + actors.size()) {
+        buildPath(a.pos, goal, a);   // not one of ours (player etc): just solve it
+        return;
+    }
+    const int ai = int(&a - actors.data());
+
+    int gc = tileIndexAt(goal);
+    if (a.pathTicket != 0 && a.pathGoalCell == gc) {
+        ++pathReqDeduped;
+        return;
+    }
+
+    // New ticket; anything this actor had queued is now stale
+    a.pathTicket = nextPathTicket++;
+    if (nextPathTicket == 0) nextPathTicket = 1;
+    a.pathGoalCell = gc;
+
+    PathRequest rq;
+    rq.actor = ai;
+    rq.ticket = a.pathTicket;
+    rq.goalCell = gc;
+    rq.goalPos = goal;
+    // Later requests rank further back, so the aging never has to touch the heap
+    rq.priority = (playerPresent ? length(a.pos - player.pos) : 0.0f)
+        + gameTimeS * cfg::PathQueueAgeTilesPerS * cfg::TileSize;
+    pathQueue.push_back(rq);
+    std::push_heap(pathQueue.begin(), pathQueue.end(), pathRequestLater);
+}
+
+// Serve queued requests nearest-to-player first (aged, see cfg::PathBudgetUs)
+// until the frame budget is spent. Always serves at least one, so a long search
+// can't starve the queue.
+void Game::servicePathQueue() {
+    if (pathQueue.empty()) return;
+
+    struct Served { int start, goal, actor; };
+    Served served[32];
+    int servedCount = 0;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    int done = 0;
+    while (!pathQueue.empty()) {
+        if (done > 0) {
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - t0).count();
+            if (us >= cfg::PathBudgetUs) break;
+        }
+
+        std::pop_heap(pathQueue.begin(), pathQueue.end(), pathRequestLater);
+        PathRequest rq = pathQueue.back();
+        pathQueue.pop_back();
+
+        if (rq.actor < 0 || rq.actor >= (int)actors.size()) continue;
+        Actor& a = actors[rq.actor];
+        if (!a.alive() || a.pathTicket != rq.ticket) {
+            ++pathReqCancelled;
+            continue;
+        }
+        a.pathTicket = 0;
+        a.pathGoalCell = -1;
+
+        // Same start and goal tile as someone served this frame: copy theirs
+        int sc = tileIndexAt(a.pos);
+        const Served* same = nullptr;
+        for (int i = 0; i < servedCount; ++i) {
+            if (served[i].start == sc && served[i].goal == rq.goalCell) same = &served[i];
+        }
+
+        float keepRepath = a.repathTimer;   // buildPath zeroes it; the caller's timer stands
+        if (same) {
+            const Actor& src = actors[same->actor];
+            a.path = src.path;
+            a.pathIndex = src.path.empty() ? -1 : 0;
+            a.navRoute = src.navRoute;
+            a.navRouteIndex = src.navRouteIndex;
+            ++pathReqShared;
+        }
+        else {
+            buildPath(a.pos, rq.goalPos, a);
+            if (servedCount < 32) served[servedCount++] = { sc, rq.goalCell, rq.actor };
+            ++done;
+        }
+        a.repathTimer = keepRepath;
+        ++pathReqServed;
+    }
 }
 
 Vec2 Game::findNearestCoverToward(const Vec2& from, const Vec2& threat) const {
@@ -3297,123 +5676,676 @@ Vec2 Game::findNearestCoverToward(const Vec2& from, const Vec2& threat) const {
 // LOS + hearing + threat acquisition
 // -----------------------------------------------------------
 
-bool Game::losClear(const Vec2& a, const Vec2& b) const {
-    const int steps = 32;
-    Vec2 d = b - a;
-    for (int i = 1; i <= steps; ++i) {
-        float t = float(i) / float(steps);
-        Vec2 p = a + d * t;
-        int c = int(p.x / cfg::TileSize);
-        int r = int(p.y / cfg::TileSize);
-        if (!inBoundsTile(c, r)) return false;
-        Tile tile = map.at(c, r);
-        if (tile == Tile::Wall || tile == Tile::Water) {
-            return false;
+// Amanatides-Woo walk: every tile the segment a->b touches, in order, each once.
+// At an exact tile corner both side tiles are visited before the diagonal one,
+// so nothing slips between two walls that only touch at a corner.
+template <class Visit>
+bool Game::traverseTiles(const Vec2& a, const Vec2& b, Visit&& visit) const {
+    const float inv = 1.0f / cfg::TileSize;
+    const float x0 = a.x * inv, y0 = a.y * inv;
+    const float x1 = b.x * inv, y1 = b.y * inv;
+    int c = (int)std::floor(x0), r = (int)std::floor(y0);
+    const int ce = (int)std::floor(x1), re = (int)std::floor(y1);
+
+    const float dx = x1 - x0, dy = y1 - y0;
+    const int stepC = dx > 0.0f ? 1 : -1;
+    const int stepR = dy > 0.0f ? 1 : -1;
+    const float infT = std::numeric_limits<float>::infinity();
+    const float tDeltaX = dx != 0.0f ? std::fabs(1.0f / dx) : infT;
+    const float tDeltaY = dy != 0.0f ? std::fabs(1.0f / dy) : infT;
+    float tMaxX = dx != 0.0f ? (stepC > 0 ? (c + 1 - x0) : (x0 - c)) * tDeltaX : infT;
+    float tMaxY = dy != 0.0f ? (stepR > 0 ? (r + 1 - y0) : (y0 - r)) * tDeltaY : infT;
+
+    // The segment crosses exactly n tile borders, so the walk is n steps long no
+    // matter what float drift does to tMax. The x-or-y pick is written as selects:
+    // which way a ray turns next is a coin flip to the branch predictor. The exact
+    // corner case stays a branch; rays almost never hit one, so it predicts well.
+    // A corner is only taken whole if the target is past it on both axes; one
+    // that lies on the segment's end just steps the axis still short of it.
+    int n = std::abs(ce - c) + std::abs(re - r);
+    if (!visit(c, r)) return false;
+    while (n > 0) {
+        const bool tie = tMaxX == tMaxY;
+        if (tie && c != ce && r != re) {
+            if (!visit(c + stepC, r) || !visit(c, r + stepR)) return false;
+            tMaxX += tDeltaX; tMaxY += tDeltaY;
+            c += stepC; r += stepR; n -= 2;
         }
+        else {
+            const bool sx = tie ? c != ce : tMaxX < tMaxY;
+            tMaxX += sx ? tDeltaX : 0.0f;
+            tMaxY += sx ? 0.0f : tDeltaY;
+            c += sx ? stepC : 0;
+            r += sx ? 0 : stepR;
+            --n;
+        }
+        if (!visit(c, r)) return false;
     }
     return true;
 }
 
+// LOS is always walked top-down (then left-right), so A sees B exactly when B
+// sees A: float ties at tile corners could otherwise break differently each way.
+static inline bool losWalkReversed(const Vec2& a, const Vec2& b) {
+    return b.y < a.y || (b.y == a.y && b.x < a.x);
+}
+
+bool Game::losClear(const Vec2& a, const Vec2& b) const {
+    const bool flip = losWalkReversed(a, b);
+    return traverseTiles(flip ? b : a, flip ? a : b, [&](int c, int r) {
+        Tile t = map.at(c, r);   // off-map reads as Wall
+        return t != Tile::Wall && t != Tile::Water;
+        });
+}
+
+// One eye, many targets (threat scans): bounds and the tile array are resolved
+// once, and each ray reads the raw array instead of going through map.at().
+// Same walk direction as losClear, so the answers are the same bit for bit.
+void Game::losClearBatch(const Vec2& from, const Vec2* targets, int count, bool* out) const {
+    const int cols = map.cols, rows = map.rows;
+    const Tile* tiles = map.tiles.data();
+    auto opaque = [&](int c, int r) {
+        if ((unsigned)c >= (unsigned)cols || (unsigned)r >= (unsigned)rows) return true;
+        Tile t = tiles[r * cols + c];
+        return t == Tile::Wall || t == Tile::Water;
+        };
+    const int fc = (int)std::floor(from.x / cfg::TileSize);
+    const int fr = (int)std::floor(from.y / cfg::TileSize);
+    if (opaque(fc, fr)) {
+        std::fill(out, out + count, false);
+        return;
+    }
+    auto clear = [&](int c, int r) { return !opaque(c, r); };
+    for (int i = 0; i < count; ++i) {
+        out[i] = losWalkReversed(from, targets[i]) ? traverseTiles(targets[i], from, clear)
+            : traverseTiles(from, targets[i], clear);
+    }
+}
+
+// Tile pairs are symmetric (the walk visits both side tiles at corners either
+// way), so every ray is walked once from the lower index and sets both bits.
+// A wide pair is clear too, so the plain walk only runs where the wide one fails.
+void Game::rebuildPvs() {
+    const int count = map.cols * map.rows;
+    const int R = cfg::PvsRadius;
+    const int side = 2 * R + 1;
+    pvs.clear();
+    pvsWide.clear();
+    pvsOpen.clear();
+    pvsWords = 0;
+    if (count > cfg::PvsMaxTiles) return;
+
+    pvsWords = (side * side + 63) / 64;
+    pvs.assign((size_t)count * pvsWords, 0);
+    pvsWide.assign((size_t)count * pvsWords, 0);
+    pvsOpen.assign(count, 0);
+    for (int r = 0; r < map.rows; ++r)
+        for (int c = 0; c < map.cols; ++c) refreshPvsOpen(c, r);
+    auto setBit = [&](std::vector<uint64_t>& bits, int from, int to) {
+        int k = (to / map.cols - from / map.cols + R) * side + (to % map.cols - from % map.cols + R);
+        bits[(size_t)from * pvsWords + (k >> 6)] |= 1ull << (k & 63);
+        };
+
+    for (int s = 0; s < count; ++s) {
+        const int sc = s % map.cols, sr = s / map.cols;
+        Tile st = map.tiles[s];
+        if (st == Tile::Wall || st == Tile::Water) continue;
+        for (int r = std::max(0, sr - R); r <= std::min(map.rows - 1, sr + R); ++r)
+            for (int c = std::max(0, sc - R); c <= std::min(map.cols - 1, sc + R); ++c) {
+                int t = r * map.cols + c;
+                if (t < s) continue;
+                const bool wide = pvsRay(s, t, true);
+                if (!wide && !pvsRay(s, t, false)) continue;
+                setBit(pvs, s, t);
+                setBit(pvs, t, s);
+                if (!wide) continue;
+                setBit(pvsWide, s, t);
+                setBit(pvsWide, t, s);
+            }
+    }
+}
+
+// Only rays that pass within a tile of the painted one can change (the wide
+// bit reads its neighbours), and such a ray has both ends within the radius
+// plus one of it. A ray touches a neighbour's square only if the painted
+// tile's centre is within 1.5 diagonals of the segment, which rules out most
+// pairs before any walking.
+void Game::updatePvs(int c, int r) {
+    if (pvs.empty()) return;
+    for (int nr = std::max(0, r - 1); nr <= std::min(map.rows - 1, r + 1); ++nr)
+        for (int nc = std::max(0, c - 1); nc <= std::min(map.cols - 1, c + 1); ++nc) refreshPvsOpen(nc, nr);
+    const int R = cfg::PvsRadius;
+    const int side = 2 * R + 1;
+    const int c0 = std::max(0, c - R - 1), c1 = std::min(map.cols - 1, c + R + 1);
+    const int r0 = std::max(0, r - R - 1), r1 = std::min(map.rows - 1, r + R + 1);
+
+    auto putBit = [&](std::vector<uint64_t>& bits, int from, int to, bool on) {
+        int k = (to / map.cols - from / map.cols + R) * side + (to % map.cols - from % map.cols + R);
+        uint64_t& w = bits[(size_t)from * pvsWords + (k >> 6)];
+        if (on) w |= 1ull << (k & 63);
+        else    w &= ~(1ull << (k & 63));
+        };
+
+    for (int sr = r0; sr <= r1; ++sr)
+        for (int sc = c0; sc <= c1; ++sc) {
+            const int s = sr * map.cols + sc;
+            for (int tr = std::max(r0, sr - R); tr <= std::min(r1, sr + R); ++tr)
+                for (int tc = std::max(c0, sc - R); tc <= std::min(c1, sc + R); ++tc) {
+                    const int t = tr * map.cols + tc;
+                    if (t < s) continue;
+
+                    // Squared distance from the painted tile's centre to segment s-t
+                    float dx = float(tc - sc), dy = float(tr - sr);
+                    float px = float(c - sc), py = float(r - sr);
+                    float len2 = dx * dx + dy * dy;
+                    float u = len2 > 0.0f ? std::clamp((px * dx + py * dy) / len2, 0.0f, 1.0f) : 0.0f;
+                    float ex = px - u * dx, ey = py - u * dy;
+                    if (ex * ex + ey * ey > 4.5001f) continue;
+
+                    bool wide = pvsRay(s, t, true);
+                    bool vis = wide || pvsRay(s, t, false);
+                    putBit(pvs, s, t, vis);
+                    putBit(pvs, t, s, vis);
+                    putBit(pvsWide, s, t, wide);
+                    putBit(pvsWide, t, s, wide);
+                }
+        }
+}
+
+// Off-map neighbours count as open: rays between on-map points never reach them.
+void Game::refreshPvsOpen(int c, int r) {
+    uint8_t open = 1;
+    for (int nr = std::max(0, r - 1); nr <= std::min(map.rows - 1, r + 1); ++nr)
+        for (int nc = std::max(0, c - 1); nc <= std::min(map.cols - 1, c + 1); ++nc) {
+            Tile t = map.at(nc, nr);
+            if (t == Tile::Wall || t == Tile::Water) open = 0;
+        }
+    pvsOpen[(size_t)r * map.cols + c] = open;
+}
+
+// Same walk as losClear between the two centres, minus the bounds checks (a
+// segment between two on-map centres never leaves the map). The wide walk needs
+// each tile's whole 3x3 open: any ray between points of the two end tiles stays
+// within a tile of the centre segment, so it can only cross those neighbours.
+bool Game::pvsRay(int fromIdx, int toIdx, bool wide) const {
+    const Tile* tiles = map.tiles.data();
+    const uint8_t* open = pvsOpen.data();
+    auto clear = [&](int i) { return wide ? open[i] != 0 : tiles[i] != Tile::Wall && tiles[i] != Tile::Water; };
+    if (!clear(fromIdx) || !clear(toIdx)) return false;
+    const int cols = map.cols;
+    if (toIdx < fromIdx) std::swap(fromIdx, toIdx);
+    return traverseTiles(tileCenterOf(fromIdx), tileCenterOf(toIdx),
+        [&](int c, int r) { return clear(r * cols + c); });
+}
+
+int Game::pvsLookup(const Vec2& a, const Vec2& b) const {
+    if (pvs.empty()) return -1;
+    const int R = cfg::PvsRadius;
+    int ac = (int)std::floor(a.x / cfg::TileSize), ar = (int)std::floor(a.y / cfg::TileSize);
+    int bc = (int)std::floor(b.x / cfg::TileSize), br = (int)std::floor(b.y / cfg::TileSize);
+    if (!inBoundsTile(ac, ar) || !inBoundsTile(bc, br)) return -1;
+    int dc = bc - ac, dr = br - ar;
+    if (dc < -R || dc > R || dr < -R || dr > R) return -1;
+
+    int k = (dr + R) * (2 * R + 1) + (dc + R);
+    uint64_t w = pvs[(size_t)(ar * map.cols + ac) * pvsWords + (k >> 6)];
+    if (!((w >> (k & 63)) & 1ull)) return 0;
+
+    // A clear centre ray says little about off-centre ends near a wall: the real
+    // ray can clip a corner the centre one missed
+    auto atCentre = [&](const Vec2& p, int c, int r) {
+        const Vec2 ctr = tileCenterOf(r * map.cols + c);
+        return p.x == ctr.x && p.y == ctr.y;
+        };
+    if (atCentre(a, ac, ar) && atCentre(b, bc, br)) return 1;
+    uint64_t wide = pvsWide[(size_t)(ar * map.cols + ac) * pvsWords + (k >> 6)];
+    return ((wide >> (k & 63)) & 1ull) ? 1 : -1;
+}
+
+// Table answer if it holds for these exact points (see cfg::PvsRadius), else the ray
+bool Game::losVisible(const Vec2& a, const Vec2& b) const {
+    int known = pvsLookup(a, b);
+    return known >= 0 ? known != 0 : losClear(a, b);
+}
+
 bool Game::sees(const Actor& a, const Vec2& targetPos, bool& outLOS) const {
-    Vec2 to = targetPos - a.pos;
-    float dist = length(to);
-    if (dist < 1e-3f) { outLOS = false; return false; }
+    if (!inVisionCone(a, targetPos)) { outLOS = false; return false; }
 
-    // Base effective vision range (your alarm scaling)
-    float effRange = a.visionRange * (1.0f + 0.12f * (float)mission.alarmLevel);
+    bool clear = losVisible(a.pos, targetPos);
+    outLOS = clear;
+    return clear && !foliageConceals(a, targetPos);
+}
+
+// Cone survivors only: the table answers pairs it covers, the rest are walked
+// from the eye as one losClearBatch. A few enemies per actor cost less as rays
+// than as a shadowcast of the whole cone, so FOV masks are left to the overlay.
+void Game::losCullBatch(const Vec2& eye, ConeBatch& cb) const {
+    Vec2 rayTo[64];
+    int  rayK[64];
+    bool rayClear[64];
+    int numRays = 0;
+    auto flush = [&]() {
+        losClearBatch(eye, rayTo, numRays, rayClear);
+        for (int j = 0; j < numRays; ++j) {
+            if (!rayClear[j]) cb.pass[rayK[j]] = 0;
+        }
+        numRays = 0;
+        };
+
+    const int n = (int)cb.xs.size();
+    for (int k = 0; k < n; ++k) {
+        if (!cb.pass[k]) continue;
+        Vec2 p{ cb.xs[k], cb.ys[k] };
+        int known = pvsLookup(eye, p);
+        if (known >= 0) {
+            if (!known) cb.pass[k] = 0;
+            continue;
+        }
+        rayTo[numRays] = p;
+        rayK[numRays] = k;
+        if (++numRays == 64) flush();
+    }
+    flush();
+}
+
+// A few adds per tile the sight line crosses; the observer's own tile doesn't
+// count (you can see out of a bush), the target's does unless countTarget is off
+float Game::foliageAlong(const Vec2& from, const Vec2& to, bool countTarget) const {
+    if (foliageDensity.size() != size_t(map.cols * map.rows)) return 0.0f;
+    const int oc = (int)std::floor(from.x / cfg::TileSize);
+    const int orr = (int)std::floor(from.y / cfg::TileSize);
+    const int tc = countTarget ? -1 : (int)std::floor(to.x / cfg::TileSize);
+    const int tr = countTarget ? -1 : (int)std::floor(to.y / cfg::TileSize);
+    int sum = 0;
+    traverseTiles(from, to, [&](int c, int r) {
+        if ((c != oc || r != orr) && (c != tc || r != tr) && inBoundsTile(c, r)) sum += foliageDensity[r * map.cols + c];
+        return true;
+        });
+    return sum * (1.0f / 255.0f);
+}
+
+bool Game::foliageConceals(const Actor& a, const Vec2& targetPos) const {
+    float d2 = lenSq(targetPos - a.pos);
+    const float closeReveal = cfg::TileSize * 1.2f;
+    if (d2 <= closeReveal * closeReveal) return false;
+
+    // A target standing in a Tree tile already had the cone's concealMul; its own
+    // tile's leaves aren't charged a second time
+    float cover = foliageAlong(a.pos, targetPos, !inFoliage(targetPos));
+    if (cover <= 0.0f) return false;
+    float range = visionRangeFor(a) / (1.0f + cfg::FoliageSightFalloff * cover);
+    return d2 > range * range;
+}
+
+float Game::visionRangeFor(const Actor& a) const {
+    return a.visionRange * (1.0f + 0.12f * (float)mission.alarmLevel);
+}
+
+// Tree tiles act as brush: whoever stands in one is harder to spot
+bool Game::inFoliage(const Vec2& p) const {
+    int tc = int(p.x / cfg::TileSize);
+    int tr = int(p.y / cfg::TileSize);
+    return inBoundsTile(tc, tr) && map.at(tc, tr) == Tile::Tree;
+}
+
+ConeQuery Game::coneFor(const Actor& a) const {
+    ConeQuery q;
+    q.ox = a.pos.x;
+    q.oy = a.pos.y;
+    q.fx = a.facing.x;
+    q.fy = a.facing.y;
+
+    float effRange = visionRangeFor(a);
+    float halfDeg = std::min(180.0f, a.visionFOVDeg * 0.5f);
+    q.rangeSq = effRange * effRange;
+    q.cosHalf = std::cos(deg2rad(halfDeg));
+
+    // Foliage concealment: shorter range and a slightly narrower cone. Alarm makes
+    // everyone a bit more keyed-up (less conceal effect when alarm is high).
+    float concealMul = (mission.alarmLevel >= 3) ? 0.75f : (mission.alarmLevel >= 1 ? 0.65f : 0.55f);
+    q.concealRangeSq = q.rangeSq * concealMul * concealMul;
+    q.concealCosHalf = std::cos(deg2rad(halfDeg * 0.85f));
+
+    // Close-range always breaks concealment (you can't hide if they're right on top of you)
+    const float closeReveal = cfg::TileSize * 1.2f;
+    q.revealSq = closeReveal * closeReveal;
+    return q;
+}
+
+bool Game::inVisionCone(const Actor& a, const Vec2& targetPos) const {
+    return coneFor(a).test(targetPos.x, targetPos.y, inFoliage(targetPos));
+}
+
+
+bool Game::hears(const Actor& a, const SoundPing& s) const {
+    ++hearTestsTick;
+    float d = length(s.pos - a.pos);
+    return d <= s.radiusPx;
+}
+
+bool Game::acquireThreat(const Actor& a, Vec2& threatPos, int& threatIdx, bool& seesThreat) const {
+    int slot = -1;
+    if (&a == &player) slot = 0;
+    else if (!actors.empty() && &a >= actors.data() && &a < actors.data() + actors.size()) {
+        slot = 1 + int(&a - actors.data());
+    }
+    if (slot < 0) return scanThreat(a, threatPos, threatIdx, seesThreat);   // a copy, no slot
+
+    if ((int)perception.size() < (int)actors.size() + 1) perception.resize(actors.size() + 1);
+    PerceptionResult& pr = perception[slot];
+
+    // A target shot dead since the scan earlier this tick doesn't count. From an
+    // earlier tick the result holds only while the LOD interval hasn't run out.
+    bool stale = pr.tick == 0 ||
+        (pr.sees && pr.idx >= 0 && (pr.idx >= (int)actors.size() || !actors[pr.idx].alive()));
+    float interval = 0.0f;
+    if (!stale && pr.tick != simTick) {
+        interval = perceptionLod ? perceptionInterval(a, pr) : 0.0f;
+        stale = interval <= 0.0f || gameTimeS >= pr.nextScanS;
+    }
+    if (stale) {
+        // First scan picks a phase from the slot so distant squads don't all land on one frame
+        if (pr.tick == 0 && perceptionLod) {
+            interval = perceptionInterval(a, pr);
+            pr.nextScanS = gameTimeS + interval * std::fmod(slot * 0.618034f, 1.0f);
+        }
+        else {
+            pr.nextScanS = gameTimeS + interval;
+        }
+        pr.tick = simTick;
+        pr.found = scanThreat(a, pr.pos, pr.idx, pr.sees, &pr.seen);
+        ++perceptionScans;
+    }
+    else {
+        ++perceptionHits;
+    }
+    threatPos = pr.found ? pr.pos : threatPos;
+    threatIdx = pr.idx;
+    seesThreat = pr.sees;
+    return pr.found;
+}
+
+const ActorGrid& Game::actorGridNow() const {
+    if (actorGrid.tick != simTick || actorGrid.builtFor != (int)actors.size()) {
+        actorGrid.build(actors, map.cols, map.rows, simTick);
+    }
+    return actorGrid;
+}
+
+unsigned Game::enemyFactionMask(Faction f) const {
+    unsigned m = 0;
+    for (int g = 0; g < 4; ++g) if (areEnemies(f, (Faction)g)) m |= 1u << g;
+    return m;
+}
+
+const Game::FactionVis& Game::factionVisFor(Faction f) const {
+    FactionVis& v = factionVis[(int)f];
+    if (v.tick == simTick) return v;
+    v.tick = simTick;
+
+    const int slots = (int)actors.size() + 1;
+    v.visibleBy.assign(slots, 0);
+    v.nearestObs.assign(slots, -1);
+    v.nearestD2.assign(slots, std::numeric_limits<float>::max());
+    v.obsStart.assign(slots + 1, 0);
+    v.obsTargets.clear();
+
+    // Each member's scan already cone-culled and LOS-tested its enemies; a result
+    // kept by the LOD may name someone who has died since
+    Vec2 p;
+    int idx = -1;
+    bool seen = false;
+    for (int slot = 0; slot < slots; ++slot) {
+        v.obsStart[slot] = (int)v.obsTargets.size();
+        const Actor& a = slot == 0 ? player : actors[slot - 1];
+        if (a.team != f || !a.alive() || (slot == 0 && !playerPresent)) continue;
+
+        acquireThreat(a, p, idx, seen);
+        if (slot >= (int)perception.size()) continue;
+        for (int t : perception[slot].seen) {
+            if (t >= slots) continue;
+            const Actor& o = t == 0 ? player : actors[t - 1];
+            if (!o.alive() || (t == 0 && !playerPresent)) continue;
+
+            v.obsTargets.push_back(t);
+            if (v.visibleBy[t] < 0xFFFF) ++v.visibleBy[t];
+            float d2 = lenSq(o.pos - a.pos);
+            if (d2 < v.nearestD2[t]) { v.nearestD2[t] = d2; v.nearestObs[t] = slot; }
+        }
+    }
+    v.obsStart[slots] = (int)v.obsTargets.size();
+    return v;
+}
+
+float Game::perceptionInterval(const Actor& a, const PerceptionResult& pr) const {
+    if (&a == &player || pr.sees || a.recentlyHit) return 0.0f;
+    if (a.state != AIState::Patrol && a.state != AIState::Idle) return 0.0f;
+
+    // Distance to the player, or to the middle of the screen when there's none
+    Vec2 focus = playerPresent ? player.pos
+        : Vec2{ camX + cfg::ScreenW * 0.5f / zoom, camY + cfg::ScreenH * 0.5f / zoom };
+    float d2 = lenSq(a.pos - focus);
+    const float nearPx = cfg::PerceptNearTiles * cfg::TileSize;
+    const float farPx = cfg::PerceptFarTiles * cfg::TileSize;
+    if (d2 <= nearPx * nearPx) return 0.0f;
+    return d2 <= farPx * farPx ? 1.0f / cfg::PerceptMidHz : 1.0f / cfg::PerceptFarHz;
+}
+
+void Game::wakePerception(const Actor& a) {
+    if (&a < actors.data() || &a >= actors.data() + actors.size()) return;
+    size_t slot = 1 + size_t(&a - actors.data());
+    if (slot < perception.size()) perception[slot].nextScanS = 0.0f;
+}
+
+void Game::emitSound(const Vec2& pos, float radiusPx, float ttl, int emitter) {
+    // Same emitter, same short window: move its last ping to the new noise instead
+    // of stacking another one (footsteps are every frame). It keeps whatever of the
+    // old circle still reaches round the new spot, so it never covers more than the
+    // noises it stands for did, and threatPos is where the emitter is now.
+    SoundPing* prev = nullptr;
+    if (emitter != -2) {
+        for (int i = (int)sounds.size() - 1; i >= 0; --i) {
+            if (sounds[i].emitter == emitter) { prev = &sounds[i]; break; }
+        }
+        if (prev && gameTimeS - prev->bornS > cfg::SoundCoalesceS) prev = nullptr;
+    }
+    if (prev) {
+        prev->radiusPx = std::max(radiusPx, prev->radiusPx - length(pos - prev->pos));
+        prev->pos = pos;
+        prev->ttl = std::max(prev->ttl, ttl);
+        ++soundsCoalesced;
+    }
+    else {
+        sounds.push_back({ pos, radiusPx, ttl, emitter, gameTimeS });
+    }
+    soundGrid.dirty = true;
+    actorGridNow().query(pos.x, pos.y, radiusPx, 0xFu, [&](int i) {
+        if (i + 1 < (int)perception.size() && lenSq(actors[i].pos - pos) <= radiusPx * radiusPx) {
+            perception[i + 1].nextScanS = 0.0f;
+        }
+        });
+}
 
-    // --- Foliage concealment (Tree tile acts as “brush”) ---
-    // If the TARGET is standing in a Tree tile, reduce detection range and narrow FOV slightly.
-    // This makes “staying hidden in foliage” actually work again.
-    int tc = int(targetPos.x / cfg::TileSize);
-    int tr = int(targetPos.y / cfg::TileSize);
-    bool targetInTrees = false;
-    if (inBoundsTile(tc, tr)) {
-        Tile t = map.at(tc, tr);
-        targetInTrees = (t == Tile::Tree);
+const FovMask& Game::fovFor(const Actor& a) const {
+    int slot = -1;
+    if (&a == &player) slot = 0;
+    else if (!actors.empty() && &a >= actors.data() && &a < actors.data() + actors.size()) {
+        slot = 1 + int(&a - actors.data());
     }
-
-    // Close-range always breaks concealment (you can’t hide if they’re right on top of you)
-    const float closeReveal = cfg::TileSize * 1.2f;
-
-    float fovMul = 1.0f;
-    if (targetInTrees && dist > closeReveal) {
-        // Alarm makes everyone a bit more keyed-up (less conceal effect when alarm is high)
-        float concealMul = (mission.alarmLevel >= 3) ? 0.75f : (mission.alarmLevel >= 1 ? 0.65f : 0.55f);
-        effRange *= concealMul;
-        fovMul = 0.85f;
+    if (slot < 0) {
+        computeFov(a, fovScratch);
+        return fovScratch;
     }
+    if ((int)fovMasks.size() < (int)actors.size() + 1) fovMasks.resize(actors.size() + 1);
+    FovMask& m = fovMasks[slot];
+    if (m.tick != simTick) {
+        computeFov(a, m);
+        m.tick = simTick;
+    }
+    return m;
+}
 
-    if (dist > effRange) { outLOS = false; return false; }
-
-    Vec2 dir = normalize(to);
-    float dot = a.facing.x * dir.x + a.facing.y * dir.y;
-    float angDeg = std::acos(std::clamp(dot, -1.0f, 1.0f)) * 180.0f / 3.14159265f;
-
-    if (angDeg > (a.visionFOVDeg * 0.5f) * fovMul) { outLOS = false; return false; }
-
-    bool clear = losClear(a.pos, targetPos);
-    outLOS = clear;
-    return clear;
+// Recursive shadowcasting (Bergstrom), one call per octant. Walls and water
+// block and are visible themselves; trees only hide whoever stands in them,
+// which inVisionCone handles.
+void Game::computeFov(const Actor& a, FovMask& m) const {
+    const float T = (float)cfg::TileSize;
+    const float rangeTiles = visionRangeFor(a) / T;
+    const int oc = (int)std::floor(a.pos.x / T);
+    const int orr = (int)std::floor(a.pos.y / T);
+    m.reset(oc, orr, (int)std::ceil(rangeTiles));
+    if (inBoundsTile(oc, orr)) m.set(oc, orr);
+
+    // Tiles count as in the cone if any part of them could be; half a tile of
+    // slack so targets standing off-centre near the edge aren't cut
+    const Vec2 facing = normalize(a.facing);
+    const float cosHalf = std::cos(deg2rad(std::min(180.0f, a.visionFOVDeg * 0.5f)));
+    const float cosReach = std::cos(std::min(3.14159265f, deg2rad(a.visionFOVDeg * 0.5f + 22.5f) + 0.05f));
+
+    static const int mult[4][8] = {
+        { 1, 0, 0,-1,-1, 0, 0, 1 },
+        { 0, 1,-1, 0, 0,-1, 1, 0 },
+        { 0, 1, 1, 0, 0,-1,-1, 0 },
+        { 1, 0, 0, 1,-1, 0, 0,-1 },
+    };
+    for (int o = 0; o < 8; ++o) {
+        // Skip octants the cone can't reach (45 deg wedge, so 22.5 deg either side of its middle)
+        Vec2 mid = normalize(Vec2{ -0.4142f * mult[0][o] - mult[1][o], -0.4142f * mult[2][o] - mult[3][o] });
+        if (mid.x * facing.x + mid.y * facing.y < cosReach) continue;
+        castFovLight(m, 1, 1.0f, 0.0f, mult[0][o], mult[1][o], mult[2][o], mult[3][o], facing, cosHalf, rangeTiles);
+    }
 }
 
+void Game::castFovLight(FovMask& m, int row, float start, float end,
+    int xx, int xy, int yx, int yy, const Vec2& facing, float cosHalf, float rangeTiles) const {
+    if (start < end) return;
+    const int radius = m.radius;
+    const float rangeSq = (rangeTiles + 0.5f) * (rangeTiles + 0.5f);
+    auto opaque = [&](int c, int r) {
+        Tile t = map.at(c, r);   // off-map reads as Wall
+        return t == Tile::Wall || t == Tile::Water;
+        };
+
+    float newStart = 0.0f;
+    for (int j = row; j <= radius; ++j) {
+        int dx = -j - 1, dy = -j;
+        bool blocked = false;
+        while (dx <= 0) {
+            ++dx;
+            const int wx = dx * xx + dy * xy;
+            const int wy = dx * yx + dy * yy;
+            const int c = m.originC + wx;
+            const int r = m.originR + wy;
+            const float lSlope = (dx - 0.5f) / (dy + 0.5f);
+            const float rSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < rSlope) continue;
+            if (end > lSlope) break;
+
+            const float d2 = float(wx * wx + wy * wy);
+            if (d2 <= rangeSq && inBoundsTile(c, r)) {
+                float d = std::sqrt(d2);
+                float slack = 0.71f / d;   // half a tile diagonal, as a cosine margin
+                if (wx * facing.x + wy * facing.y >= (cosHalf - slack) * d) m.set(c, r);
+            }
 
-bool Game::hears(const Actor& a, const SoundPing& s) const {
-    float d = length(s.pos - a.pos);
-    return d <= s.radiusPx;
+            if (blocked) {
+                if (opaque(c, r)) { newStart = rSlope; continue; }
+                blocked = false;
+                start = newStart;
+            }
+            else if (opaque(c, r) && j < radius) {
+                blocked = true;
+                castFovLight(m, j + 1, start, lSlope, xx, xy, yx, yy, facing, cosHalf, rangeTiles);
+                newStart = rSlope;
+            }
+        }
+        if (blocked) break;
+    }
 }
 
-bool Game::acquireThreat(const Actor& a, Vec2& threatPos, int& threatIdx, bool& seesThreat) const {
+bool Game::scanThreat(const Actor& a, Vec2& threatPos, int& threatIdx, bool& seesThreat,
+    std::vector<int>* outSeen) const {
     threatIdx = -1;
     seesThreat = false;
+    if (outSeen) outSeen->clear();
     bool found = false;
     float bestScore = -1.0f;
 
-    auto considerVisual = [&](const Vec2& p, int idx) {
-        bool los = false;
-        if (!sees(a, p, los) || !los) return;
-
-        float dist = length(p - a.pos);
-        float effRange = a.visionRange * (1.0f + 0.12f * (float)mission.alarmLevel);
-        float score = 2.0f + (effRange - dist) * 0.01f; // heavier than hearing
-        if (score > bestScore) {
-            bestScore = score;
-            found = true;
-            seesThreat = true;
-            threatPos = p;
-            threatIdx = idx;
-        }
-        };
-
-    // Visual: player
+    // Visual: pack the live enemies in range (player included; the rest from the
+    // actor grid, in index order like a full scan), cull the lot against the cone
+    // in one batch, then only the survivors get a line of sight check
+    ConeBatch& cb = coneBatch;
+    cb.clear();
     if (playerPresent && player.alive() && areEnemies(a.team, player.team)) {
-        considerVisual(player.pos, -1);
+        cb.push(player.pos, inFoliage(player.pos), -1);
     }
-
-    // Visual: other actors
-    for (int i = 0; i < (int)actors.size(); ++i) {
+    nearIds.clear();
+    actorGridNow().query(a.pos.x, a.pos.y, visionRangeFor(a), enemyFactionMask(a.team),
+        [&](int i) { nearIds.push_back(i); });
+    std::sort(nearIds.begin(), nearIds.end());
+    for (int i : nearIds) {
         const Actor& o = actors[i];
         if (!o.alive()) continue;
-        if (!areEnemies(a.team, o.team)) continue;
-        considerVisual(o.pos, i);
+        cb.push(o.pos, inFoliage(o.pos), i);
+    }
+
+    const int n = (int)cb.xs.size();
+    if (n > 0) {
+        cb.pass.resize(n);
+        coneCullBatch(coneFor(a), cb.xs.data(), cb.ys.data(), cb.trees.data(), n, cb.pass.data());
+        losCullBatch(a.pos, cb);
+
+        const float effRange = visionRangeFor(a);
+        for (int k = 0; k < n; ++k) {
+            if (!cb.pass[k]) continue;
+            Vec2 p{ cb.xs[k], cb.ys[k] };
+            if (foliageConceals(a, p)) continue;
+            if (outSeen) outSeen->push_back(cb.idx[k] + 1);
+
+            float dist = length(p - a.pos);
+            float score = 2.0f + (effRange - dist) * 0.01f; // heavier than hearing
+            if (score > bestScore) {
+                bestScore = score;
+                found = true;
+                seesThreat = true;
+                threatPos = p;
+                threatIdx = cb.idx[k];
+            }
+        }
     }
 
     // Hearing: pings
-    for (const auto& s : sounds) {
+    float hearScore = 0.0f;
+    int ping = loudestPing(a, hearScore);
+    if (ping >= 0 && hearScore > bestScore) {
+        bestScore = hearScore;
+        found = true;
+        if (!seesThreat) {
+            threatPos = sounds[ping].pos;
+            threatIdx = -1;
+        }
+    }
+
+    return found;
+}
+
+// Only the pings binned under the actor's cell can reach it. First best wins on
+// a tie, in ping order, same as walking the whole list.
+int Game::loudestPing(const Actor& a, float& outScore) const {
+    if (soundGrid.stale(map.cols, map.rows)) soundGrid.build(sounds, map.cols, map.rows);
+    const int cell = soundGrid.cellRow(a.pos.y) * soundGrid.cols + soundGrid.cellCol(a.pos.x);
+    int best = -1;
+    for (int k = soundGrid.start[cell]; k < soundGrid.start[cell + 1]; ++k) {
+        const SoundPing& s = sounds[soundGrid.ids[k]];
         if (!hears(a, s)) continue;
         float d = length(s.pos - a.pos);
         float score = 1.0f + (s.radiusPx - d) * 0.002f;
-        if (score > bestScore) {
-            bestScore = score;
-            found = true;
-            if (!seesThreat) {
-                threatPos = s.pos;
-                threatIdx = -1;
-            }
+        if (best < 0 || score > outScore) {
+            outScore = score;
+            best = soundGrid.ids[k];
         }
     }
-
-    return found;
+    return best;
 }
 
 // -----------------------------------------------------------
@@ -3600,6 +6532,13 @@ void Game::updateSquadBrain(int sid, float dt) {
     //    barks.push_back({ p, std::string(txt), ttl });
     //    };
 
+    // Visual contacts come from the faction's shared table: each enemy any member
+    // sees counts once, weighted by how many of the faction have eyes on it.
+    // Members' own scans only add what they hear.
+    const FactionVis& fv = factionVisFor(s.side);
+    if (squadSeenMark.size() < fv.visibleBy.size()) squadSeenMark.resize(fv.visibleBy.size(), 0);
+    const uint64_t mark = (uint64_t(simTick) << 32) | uint32_t(sid + 1);
+
     for (int idx : s.members) {
         if (idx < 0 || idx >= (int)actors.size()) continue;
         Actor& a = actors[idx];
@@ -3611,17 +6550,31 @@ void Game::updateSquadBrain(int sid, float dt) {
             s.timeSinceContact = 0.0f;
         }
 
+        const int slot = idx + 1;
+        const bool inTable = slot < (int)fv.visibleBy.size();   // false if spawned after the build
+        const int k0 = inTable ? fv.obsStart[slot] : 0;
+        const int k1 = inTable ? fv.obsStart[slot + 1] : 0;
+        for (int k = k0; k < k1; ++k) {
+            int t = fv.obsTargets[k];
+            if (squadSeenMark[t] == mark) continue;
+            squadSeenMark[t] = mark;
+            const Vec2& tp = t == 0 ? player.pos : actors[t - 1].pos;
+            float w = (float)fv.visibleBy[t];
+            enemyAccum.x += tp.x * w;
+            enemyAccum.y += tp.y * w;
+            enemySamples += fv.visibleBy[t];
+            contactNow = anyVisual = true;
+            s.timeSinceContact = 0.0f;
+        }
+
         Vec2 threatPos;
         int  threatIdx = -1;
         bool seesThreat = false;
-        if (acquireThreat(a, threatPos, threatIdx, seesThreat)) {
+        if (acquireThreat(a, threatPos, threatIdx, seesThreat) && !seesThreat) {
             contactNow = true;
             enemyAccum.x += threatPos.x;
             enemyAccum.y += threatPos.y;
             ++enemySamples;
-            if (seesThreat) {
-                anyVisual = true;
-            }
             s.timeSinceContact = 0.0f;
         }
     }
@@ -3903,6 +6856,7 @@ auto clamp0 = [](float v) { return v < 0.f ? 0.f : v; };
             if (!a.alive()) continue;
 
             a.hasOrder = false; // reset, then set below if needed
+            a.flowGoal = -1;
 
             switch (s.intent) {
             case SquadIntent::Hold: {
@@ -3922,6 +6876,7 @@ auto clamp0 = [](float v) { return v < 0.f ? 0.f : v; };
                 float sideAmt = 24.0f + 8.0f * (aliveIndex / 2);
                 Vec2 advancePos = contactPos + right * side * sideAmt;
                 a.orderPos = advancePos;
+                a.flowGoal = tileIndexAt(contactPos);
             } break;
 
             case SquadIntent::Flank: {
@@ -3954,11 +6909,13 @@ auto clamp0 = [](float v) { return v < 0.f ? 0.f : v; };
                     // SUPPORT
                     a.hasOrder = true;
                     a.orderPos = mid;
+                    a.flowGoal = tileIndexAt(mid);
                 }
                 else {
                     // FLANKERS
                     a.hasOrder = true;
                     a.orderPos = flankTarget;
+                    a.flowGoal = tileIndexAt(flankTarget);
                 }
             } break;
 
@@ -3991,6 +6948,7 @@ auto clamp0 = [](float v) { return v < 0.f ? 0.f : v; };
                     float angle = (6.2831853f * (float)aliveIndex) / std::max(1, n);
                     Vec2 off{ std::cos(angle) * 40.0f, std::sin(angle) * 40.0f };
                     a.orderPos = searchPos + off;
+                    a.flowGoal = tileIndexAt(searchPos);
                 }
             } break;
             }
@@ -4062,6 +7020,7 @@ auto clamp0 = [](float v) { return v < 0.f ? 0.f : v; };
                     }
                     if (pick >= 0) {
                         actors[pick].hasOrder = true;
+                        actors[pick].flowGoal = -1;
                         actors[pick].orderPos = s.currentGoal + Vec2{ frand(-40.f, 40.f), frand(-40.f, 40.f) };
                     }
                 }
@@ -4159,6 +7118,73 @@ void Game::raiseAlarm(int level) {
 
 
 
+// -----------------------------------------------------------
+// Loot drops
+// -----------------------------------------------------------
+
+int Game::findNearestLoot(const Vec2& p, float maxDist) const {
+    if (lootIndex.stale(map.cols, map.rows)) lootIndex.build(lootDrops, map.cols, map.rows);
+    return lootIndex.nearest(lootDrops, p, maxDist);
+}
+
+// Two drops are one pile only if nothing but the rounds tells them apart: plain
+// ammo of the same gun, or weapon instances equal in every other field (a gun
+// with its own uid, look or state keeps its own drop).
+static bool lootMergeable(const LootDrop& a, const LootDrop& b) {
+    if (a.hasInst != b.hasInst) return false;
+    if (!a.hasInst) return a.wid == b.wid;
+    const WeaponInstance& x = a.inst;
+    const WeaponInstance& y = b.inst;
+    return x.id == y.id && x.uid == y.uid && x.visualSeed == y.visualSeed &&
+        x.fireTimer == y.fireTimer && x.reloading == y.reloading && x.reloadTimer == y.reloadTimer;
+}
+
+void Game::addLootDrop(const LootDrop& d) {
+    if (cfg::LootMergePx > 0.0f) {
+        if (lootIndex.stale(map.cols, map.rows)) lootIndex.build(lootDrops, map.cols, map.rows);
+        int mi = lootIndex.nearestWhere(lootDrops, d.pos, cfg::LootMergePx,
+            [&](const LootDrop& m) { return lootMergeable(m, d); });
+        if (mi >= 0) {
+            // Same gun on the same spot: one pile, all the rounds loose
+            LootDrop& m = lootDrops[mi];
+            if (m.hasInst) {
+                m.inst.reserveAmmo += d.inst.magAmmo + d.inst.reserveAmmo;
+                syncLootLegacyFromInst(m);
+            }
+            else {
+                m.ammoLoose += d.magAmmo + d.ammoLoose;
+            }
+            return;
+        }
+    }
+    lootDrops.push_back(d);
+    lootIndex.dirty = true;
+}
+
+// Once per tick: compact away taken drops and despawn the oldest past the cap.
+// lootIdx (the open loot menu) is remapped, or closed if its drop went.
+void Game::updateLoot() {
+    int live = 0;
+    for (const LootDrop& d : lootDrops) live += d.taken ? 0 : 1;
+    int excess = std::max(0, live - cfg::LootMaxDrops);
+    if (live == (int)lootDrops.size() && excess == 0) return;
+
+    int w = 0, newLootIdx = -1;
+    for (int i = 0; i < (int)lootDrops.size(); ++i) {
+        LootDrop& d = lootDrops[i];
+        if (d.taken) continue;
+        if (excess > 0 && i != lootIdx) { --excess; continue; }   // oldest first, not the one in the menu
+        if (i == lootIdx) newLootIdx = w;
+        if (w != i) lootDrops[w] = std::move(d);
+        ++w;
+    }
+    lootDrops.resize(w);
+    lootIndex.dirty = true;
+
+    lootIdx = newLootIdx;
+    if (lootIdx < 0) lootMode = false;
+}
+
 // -----------------------------------------------------------
 // AI update
 // -----------------------------------------------------------
@@ -4206,7 +7232,7 @@ void Game::updateAI(Actor& a, float dt) {
         if (calmState && frand(0.f, 1.f) < 0.10f * dt) {
             const float aiLootRadius = 34.0f;
 
-            int li = findNearestLoot(lootDrops, a.pos, aiLootRadius);
+            int li = findNearestLoot(a.pos, aiLootRadius);
             if (li >= 0 && li < (int)lootDrops.size()) {
                 LootDrop& d = lootDrops[li];
                 if (!d.taken) {
@@ -4291,7 +7317,7 @@ void Game::updateAI(Actor& a, float dt) {
         Vec2 toP   = player.pos - a.pos;
         float dist = length(toP);
 
-        if (dist < a.visionRange * 0.8f && losClear(a.pos, player.pos))
+        if (dist < a.visionRange * 0.8f && losVisible(a.pos, player.pos))
         {
             // Allies see the player but not yet "known" as friendly
             if (!playerKnownToAllies)
@@ -4347,7 +7373,6 @@ void Game::updateAI(Actor& a, float dt) {
         if (sees(a, player.pos, los) && los) {
             Vec2 bestEnemyPos{};
             bool haveEnemy = false;
-            float bestD2 = 1e30f;
 
             // Prefer squad memory
             if (a.squadId >= 0 && a.squadId < (int)squads.size()) {
@@ -4358,14 +7383,10 @@ void Game::updateAI(Actor& a, float dt) {
                 }
             }
 
-            // Else, nearest enemy to the player (cheap scan)
+            // Else, nearest enemy to the player (grid rings outward)
             if (!haveEnemy) {
-                for (const auto& o : actors) {
-                    if (!o.alive()) continue;
-                    if (!areEnemies(player.team, o.team)) continue;
-                    float d2 = lenSq(o.pos - player.pos);
-                    if (d2 < bestD2) { bestD2 = d2; bestEnemyPos = o.pos; haveEnemy = true; }
-                }
+                int ni = actorGridNow().nearest(actors, player.pos, enemyFactionMask(player.team));
+                if (ni >= 0) { bestEnemyPos = actors[ni].pos; haveEnemy = true; }
             }
 
             if (barksEnabled && a.barkCooldown <= 0.f) {
@@ -4395,7 +7416,7 @@ void Game::updateAI(Actor& a, float dt) {
         Vec2 cover = findNearestCoverToward(a.pos, anchor);
         if (length(cover - a.pos) > 8.f) {
             if (a.path.empty() || a.repathTimer <= 0.f) {
-                buildPath(a.pos, cover, a);
+                requestPath(a, cover);
                 a.repathTimer = 1.0f;
             }
             a.state = AIState::Hunker;
@@ -4428,9 +7449,10 @@ void Game::updateAI(Actor& a, float dt) {
 
             a.state = AIState::Flee;
             a.hasOrder = true;
+            a.flowGoal = -1;
             a.orderPos = fleeDest;
             clearPath(a);
-            buildPath(a.pos, a.orderPos, a);
+            requestPath(a, a.orderPos);
             a.repathTimer = 0.6f;
             return; // commit to panic-flee this think tick
         }
@@ -4582,7 +7604,7 @@ void Game::updateAI(Actor& a, float dt) {
         if (d > 32.0f) {
             // Still travelling to the suspicious spot
             if (a.path.empty() || a.repathTimer <= 0.0f) {
-                buildPath(a.pos, a.investigatePos, a);
+                requestPath(a, a.investigatePos);
                 a.repathTimer = 0.8f;
             }
             maxSpeed = a.moveSprintSpeed;
@@ -4608,9 +7630,21 @@ void Game::updateAI(Actor& a, float dt) {
         // If the destination is extremely close, don't bother pathing.
         float d = length(dest - a.pos);
 
+        // Squad order: roll down the shared field, own path only for the last few tiles
+        if (a.hasOrder && a.flowGoal >= 0) {
+            Vec2 flowDir;
+            if (flowDirection(flowFieldTo(a.flowGoal), a.pos, flowDir)) {
+                if (!a.path.empty()) clearPath(a);
+                maxSpeed = a.moveSprintSpeed * 0.75f;
+                desiredVel = flowDir * maxSpeed;
+                a.facing = flowDir;
+                break;
+            }
+        }
+
         if (d > 12.f) {
             if (a.path.empty() || a.repathTimer <= 0.f) {
-                buildPath(a.pos, dest, a);
+                requestPath(a, dest);
                 a.repathTimer = 0.7f;
             }
         }
@@ -4674,14 +7708,14 @@ void Game::updateAI(Actor& a, float dt) {
                             b.maxRange = wd.maxRange;
                             b.dmg = (int)std::round(wd.baseDamage);
                             b.src = a.team;
-                            bullets.push_back(b);
+                            bullets.push(b);
                         }
 
                         a.weapon.magAmmo--;
                         a.weapon.fireTimer = wd.fireCooldownS;
                         a.gun.inMag = a.weapon.magAmmo;
 
-                        sounds.push_back({ a.pos, weaponNoiseRadiusPx(a.weapon.id), cfg::HearDecayS });
+                        emitSound(a.pos, weaponNoiseRadiusPx(a.weapon.id), cfg::HearDecayS, int(&a - actors.data()));
                         raiseAlarm(1);
 
                         a.burstShotsLeft--;
@@ -4709,14 +7743,14 @@ void Game::updateAI(Actor& a, float dt) {
                         b.maxRange = wd.maxRange;
                         b.dmg = (int)std::round(wd.baseDamage);
                         b.src = a.team;
-                        bullets.push_back(b);
+                        bullets.push(b);
                     }
 
                     a.weapon.magAmmo--;
                     a.weapon.fireTimer = wd.fireCooldownS;
                     a.gun.inMag = a.weapon.magAmmo;
 
-                    sounds.push_back({ a.pos, weaponNoiseRadiusPx(a.weapon.id), cfg::HearDecayS });
+                    emitSound(a.pos, weaponNoiseRadiusPx(a.weapon.id), cfg::HearDecayS, int(&a - actors.data()));
                     raiseAlarm(1);
                 }
             }
@@ -4774,7 +7808,7 @@ void Game::updateAI(Actor& a, float dt) {
         float d = length(to);
         if (d < 8.f) {
             a.pathIndex++;
-            if (a.pathIndex >= (int)a.path.size()) {
+            if (a.pathIndex >= (int)a.path.size() && !refineNavLegs(a)) {
                 clearPath(a);
                 if (a.hasOrder && length(a.orderPos - a.pos) < 12.f) {
                     a.hasOrder = false;
@@ -4818,7 +7852,13 @@ void Game::startMission(MissionKind kind) {
 
     bullets.clear();
     sounds.clear();
+    soundGrid.dirty = true;
     actors.clear();
+    pathQueue.clear();
+    perception.clear();
+    fovMasks.clear();
+    for (auto& v : factionVis) v.tick = 0;
+    invalidateActorGrid();
     squads.clear();
     corpses.clear();
     barks.clear();
@@ -4856,6 +7896,8 @@ void Game::startMission(MissionKind kind) {
     }
 
     rebuildFoliage();
+    rebuildNavData();
+    rebuildPvs();
 
     // Player spawn in one of four corners, on clear land
     {
@@ -4889,6 +7931,7 @@ void Game::startMission(MissionKind kind) {
             }
 
             if (!isClearLand(c, r)) continue;
+            if (navComponentAt(c, r) != navMainComp) continue;
             spawn = Vec2{
                 c * cfg::TileSize + cfg::TileSize * 0.5f,
                 r * cfg::TileSize + cfg::TileSize * 0.5f
@@ -5366,7 +8409,7 @@ void Game::updateMission(float dt) {
             placeSquad(bSide, (int)(center.x + offB.x), (int)(center.y + offB.y), 3 + irand(0, 1));
 
             // Fake a distant gunfire ping to wake up nearby squads
-            sounds.push_back({ center, cfg::GunshotHearTiles * cfg::TileSize * 0.85f, cfg::HearDecayS * 0.9f });
+            emitSound(center, cfg::GunshotHearTiles * cfg::TileSize * 0.85f, cfg::HearDecayS * 0.9f);
 
             if (barksEnabled) {
                 barks.push_back({ center, "Distant gunfire...", 2.2f });
@@ -5453,6 +8496,16 @@ void Game::handlePaintClick(int wx, int wy, bool leftClick) {
         undo.push(op);
         map.set(c, r, after);
         rebuildFoliage();
+        onNavTileChanged(c, r);
+        updatePvs(c, r);
+        if (!isNavWalkable(c, r)) {
+            int requeued = 0;
+            int repaired = repairPathsAfterBlock(c, r, requeued);
+            if (repaired + requeued > 0) {
+                std::printf("[PATH] tile (%d,%d) blocked: %d paths patched, %d replans queued\n",
+                    c, r, repaired, requeued);
+            }
+        }
     }
 }
 
@@ -5494,6 +8547,7 @@ void Game::handleControlClick(int wx, int wy, bool leftClick) {
             Vec2 goal = dst + offset;
             a.orderPos = goal;
             a.hasOrder = true;
+            a.flowGoal = -1;
             a.state = AIState::Seek;
             buildPath(a.pos, goal, a);
         }
@@ -5887,6 +8941,11 @@ void Game::handleEvents() {
             case SDLK_F6: showMissionParams = !showMissionParams; break;
             case SDLK_F7: squadDebugViz = !squadDebugViz;  break;
             case SDLK_F8: hudEnabled = !hudEnabled;     break;
+            case SDLK_F9:
+                pathMode = (pathMode == PathMode::AStar) ? PathMode::JumpPoint :
+                    (pathMode == PathMode::JumpPoint) ? PathMode::Hierarchical : PathMode::AStar;
+                std::printf("[PATH] mode: %s\n", pathModeName(pathMode));
+                break;
             
             case SDLK_F11:
                 if (!mission.active && !showMissionBrief && !showMissionDebrief) {
@@ -5917,7 +8976,7 @@ void Game::handleEvents() {
                 // Tap E action: ammo-only (same as your 6D-B.1 E behavior)
                 if (!playerPresent || !player.alive()) break;
 
-                int li = findNearestLoot(lootDrops, player.pos, lootRadius);
+                int li = findNearestLoot(player.pos, lootRadius);
                 if (li < 0) break;
 
                 LootDrop& d = lootDrops[li];
@@ -6006,18 +9065,233 @@ static inline const char* calloutPlayerHurt(HitZone z) {
 // Update
 // -----------------------------------------------------------
 
-void Game::update(float dt) {
-    // Update sound pings
+// Pings fade and shrink; the bins only need redoing when one goes
+void Game::updateSounds(float dt) {
     for (auto& s : sounds) {
         s.ttl -= dt;
         s.radiusPx = std::max(0.f, s.radiusPx - (cfg::TileSize * dt * 3.f));
     }
+    size_t pingsBefore = sounds.size();
     sounds.erase(
         std::remove_if(sounds.begin(), sounds.end(),
             [](const SoundPing& s) { return s.ttl <= 0.f || s.radiusPx <= 0.f; }),
         sounds.end());
+    if (sounds.size() != pingsBefore) soundGrid.dirty = true;
+}
+
+// Bullets are tested along the whole segment they moved this tick, not at the
+// point they ended on: at rifle speed one 30 Hz step is longer than a pawn is
+// wide, so point tests let shots pass through walls and people depending on
+// frame rate. The earliest of wall, trunk, player and actor impacts wins.
+void Game::updateBullets(float dt) {
+    // Bullets move (per-weapon speed/range)
+    bullets.integrate(dt);
+    deadBullets.clear();
+
+    const ActorGrid& grid = actorGridNow();
+
+    // Bullet collision vs map + player + actors
+    for (int bi = 0; bi < bullets.size(); ++bi)
+    {
+        Bullet b = bullets.get(bi);
+        const Vec2 move = b.pos - b.prev;
+        const float step = length(move);
+
+        // Lifetime: only the part of the move inside maxRange can hit anything
+        float tEnd = 1.0f;
+        if (b.traveled > b.maxRange)
+            tEnd = step > 0.0f ? std::clamp(1.0f - (b.traveled - b.maxRange) / step, 0.0f, 1.0f) : 0.0f;
+
+        // Map collision: walls/water by tile, then trunks bucketed in those tiles
+        const float tSolid = sweepSolid(b.prev, b.pos);
+
+        // Near-miss suppression: anyone the path passed close to, up to where the
+        // round stopped; nobody behind the wall it hit
+        {
+            const Vec2 to = b.prev + move * std::min(tSolid, tEnd);
+            const Vec2 mid = (b.prev + to) * 0.5f;
+            nearIds.clear();
+            grid.query(mid.x, mid.y, 70.0f + length(to - b.prev) * 0.5f, enemyFactionMask(b.src),
+                [&](int i) { nearIds.push_back(i); });
+            for (int i : nearIds)
+            {
+                Actor& a = actors[i];
+                if (!a.alive()) continue;
+
+                float d = segmentPointDist(b.prev, to, a.pos);
+                if (d < 70.0f && d >(a.w * 0.5f + 4.0f))  // close but not hit
+                {
+                    if (a.squadId >= 0)
+                        addSuppression(a.squadId, 3.0f);
+                }
+            }
+
+            // Optional: player near-miss, in case you want their behaviour later
+            // float dp = segmentPointDist(b.prev, to, player.pos);
+            // ...
+        }
+
+        // Pawns are circles of w/2 + 2 (the old point test's radius) swept
+        // against the segment; candidates come from the grid around its middle
+        int   target = -2;                 // -1 = player, i = actors[i]
+        float tTarget = 2.0f;
+        if (playerPresent && player.alive() && areEnemies(b.src, player.team))
+        {
+            float t = segmentCircleEntry(b.prev, move, player.pos, player.w * 0.5f + 2.f);
+            if (t < tTarget) { tTarget = t; target = -1; }
+        }
+
+        // Lowest index first like the old full scan, so ties go the same way
+        const Vec2 mid = b.prev + move * 0.5f;
+        nearIds.clear();
+        grid.query(mid.x, mid.y, step * 0.5f + cfg::PawnSize + 2.0f, enemyFactionMask(b.src),
+            [&](int i) { nearIds.push_back(i); });
+        std::sort(nearIds.begin(), nearIds.end());
+        for (int i : nearIds)
+        {
+            const Actor& a = actors[i];
+            if (!a.alive())                 continue;
+            float t = segmentCircleEntry(b.prev, move, a.pos, a.w * 0.5f + 2.f);
+            if (t < tTarget) { tTarget = t; target = i; }
+        }
+
+        if (target == -2 || tTarget > std::min(tEnd, tSolid))
+        {
+            if (tSolid <= tEnd || b.traveled > b.maxRange)
+                deadBullets.push_back(bi);
+            continue;
+        }
+
+        // The zone is the first rig box the shot enters; one that crosses the
+        // circle but misses every box is a torso hit, as with the point test
+        HitZone z = HitZone::Torso;
+        float tZone = tTarget;
+        sweepHitZone(target == -1 ? player : actors[target], b.prev, move,
+            std::min(tEnd, tSolid), z, tZone);
+        b.pos = b.prev + move * tZone;
+
+        // ----- Hit player ---------------------------------------------------
+        if (target == -1)
+        {
+            float mult = zoneMultiplier(z) * weaponZoneBias(b.wid, z);
+            int   dealt = (int)std::round((float)b.dmg * mult * gDamageScale);
+
+            player.hp -= dealt;
+            player.lastHitZone = z;
+            player.lastHitTime = gameTimeS;
+            player.lastShotOrigin = b.pos - b.dir * 40.0f;
+
+            // Wounds
+            if (z == HitZone::Legs)
+                player.legWoundS = std::max(player.legWoundS, 3.0f);
+            if (z == HitZone::ArmL || z == HitZone::ArmR)
+                player.armWoundS = std::max(player.armWoundS, 3.0f);
+
+            // Bark (throttled)
+            if (barksEnabled && gameTimeS >= player.nextCalloutS)
+            {
+                barks.push_back({ player.pos, calloutPlayerHurt(z), 1.2f });
+                player.nextCalloutS = gameTimeS + 0.55f;
+            }
+
+            deadBullets.push_back(bi);
+            mission.shotsHit++;
+
+            if (player.hp <= 0)
+            {
+                corpses.push_back(player.pos);
+            }
+            continue;
+        }
+
+        // ----- Hit actors ---------------------------------------------------
+        {
+            Actor& a = actors[target];
+            float mult = zoneMultiplier(z) * weaponZoneBias(b.wid, z);
+            int   dealt = (int)std::round((float)b.dmg * mult * gDamageScale);
+
+            a.hp -= dealt;
+            a.lastHitZone = z;
+            a.lastHitTime = gameTimeS;
+            a.lastShotOrigin = b.pos - b.dir * 40.0f;
+
+            // Wounds
+            if (z == HitZone::Legs)
+                a.legWoundS = std::max(a.legWoundS, 3.0f);
+            if (z == HitZone::ArmL || z == HitZone::ArmR)
+                a.armWoundS = std::max(a.armWoundS, 3.0f);
+
+            // Player callout when *player side* is the shooter
+            if (barksEnabled && b.src == player.team && gameTimeS >= player.nextCalloutS)
+            {
+                barks.push_back({ player.pos, calloutPlayerHit(z), 1.0f });
+                player.nextCalloutS = gameTimeS + 0.45f;
+            }
+
+            a.recentlyHit = true;
+            a.recentlyHitTimer = 3.0f;
+            a.lastShotOrigin = b.pos;
+            wakePerception(a);
+
+            // Suppression spike on hit
+            if (a.squadId >= 0)
+                addSuppression(a.squadId, 12.0f);
+
+            deadBullets.push_back(bi);
+            mission.shotsHit++;
+
+            if (a.hp <= 0)
+            {
+                corpses.push_back(a.pos);
+               
+                // --- Loot drop: weapon + ammo
+                {
+                    LootDrop d;
+                    d.pos = a.pos;
+
+                    d.wid = a.weapon.id;
+                    d.srcTeam = (int)a.team;
+
+                    const WeaponDef& wd = weaponDef(d.wid);
+                    d.magAmmo = std::clamp(a.weapon.magAmmo, 0, wd.magSize);
+                    d.ammoLoose = ammoRollForTeam((int)a.team);
+
+                    // New: snapshot full instance (persistent)
+                    d.inst = a.weapon;
+                    ensureWeaponIdentity(d.inst);
+
+                    d.inst.id = d.wid;
+                    d.inst.magAmmo = d.magAmmo;
+                    d.inst.reserveAmmo = d.ammoLoose;
+                    d.hasInst = true;
+
+                    syncLootLegacyFromInst(d);
+
+                    addLootDrop(d);
+                }
+
+                mission.enemiesKilled++;
+            }
+
+            raiseAlarm(1);
+        }
+    }
+
+    // Remove dead bullets, highest slot first so every slot a survivor is
+    // swapped from has already been dealt with
+    for (auto it = deadBullets.rbegin(); it != deadBullets.rend(); ++it)
+        bullets.swapRemove(*it);
+}
+
+void Game::update(float dt) {
+    ++simTick;   // perception cached last tick is stale from here on
+    hearTestsLast = hearTestsTick;
+    hearTestsTick = 0;
+
+    updateSounds(dt);
 
     gameTimeS += dt;
+    updateLoot();
 
 
     // Update barks
@@ -6061,7 +9335,7 @@ void Game::update(float dt) {
 
             // Only enter loot mode if player is alive and near loot
             if (lootHoldS >= lootHoldThreshS && playerPresent && player.alive()) {
-                int li = findNearestLoot(lootDrops, player.pos, lootRadius);
+                int li = findNearestLoot(player.pos, lootRadius);
                 if (li >= 0) {
                     lootMode = true;
                     lootIdx = li;
@@ -6123,7 +9397,7 @@ void Game::update(float dt) {
                 b.dmg = (int)std::round(wd.baseDamage);
                 b.src = player.team;
 
-                bullets.push_back(b);
+                bullets.push(b);
             }
 
             player.weapon.magAmmo--;
@@ -6139,7 +9413,7 @@ void Game::update(float dt) {
 
 
             // Gunshot ping stays loud-ish, regardless of sneak
-            sounds.push_back({ player.pos, weaponNoiseRadiusPx(player.weapon.id), cfg::HearDecayS * 0.7f });
+            emitSound(player.pos, weaponNoiseRadiusPx(player.weapon.id), cfg::HearDecayS * 0.7f, -1);
 
 
         }
@@ -6147,231 +9421,43 @@ void Game::update(float dt) {
         // Footstep noise – **none** when sneaking
         if (!sneakMode && lenSq(move) > 1.f) {
             float hearTiles = kShift ? cfg::FootstepHearSprintTiles : cfg::FootstepHearWalkTiles;
-            sounds.push_back({
-                player.pos,
-                hearTiles * cfg::TileSize,
-                cfg::HearDecayS * 0.7f
-                });
+            emitSound(player.pos, hearTiles * cfg::TileSize, cfg::HearDecayS * 0.7f, -1);
         }
     }
 
     if (playerPresent && player.alive()) {
-        int li = findNearestLoot(lootDrops, player.pos, 26.0f);
+        int li = findNearestLoot(player.pos, 26.0f);
         if (li >= 0) {
-            const LootDrop& d = lootDrops[li];
-
-            std::string msg = "E: ";
-            if (d.wid == player.weapon.id) {
-                msg += "Take ammo";
-            }
-            else {
-                msg += "Swap to ";
-                msg += weaponName(d.wid);
-            }
-
-            // TODO: replace drawText(...) with your real text function
-            // Example if you have something like drawText:
-            // drawText(msg.c_str(), 10, screenH - 24, {255,255,255,255});
-
-            // If you don’t have a neat place yet, you can even push this into
-            // your existing F1/F2 debug overlay for now as a test.
-        }
-    }
-
-
-    // Squad brains
-    for (int i = 0; i < (int)squads.size(); ++i) {
-        updateSquadBrain(i, dt);
-    }
-
-    // Bullets move (per-weapon speed/range)
-    for (auto& b : bullets) {
-        float step = b.speed * dt;
-        b.pos = b.pos + b.dir * step;
-        b.traveled += step;
-    }
-
-
-    auto bulletHitsSolid = [&](const Bullet& b) {
-        SDL_FRect r{ b.pos.x - 2.f, b.pos.y - 2.f, 4.f, 4.f };
-        return collideSolid(r);
-        };
-
-    std::vector<bool> bulletDead(bullets.size(), false);
-
-    // After moving bullets, before full collision, optional near-miss suppression:
-    for (const auto& b : bullets)
-    {
-        for (int i = 0; i < (int)actors.size(); ++i)
-        {
-            Actor& a = actors[i];
-            if (!a.alive()) continue;
-            if (!areEnemies(b.src, a.team)) continue;
-
-            float d = length(a.pos - b.pos);
-            if (d < 70.0f && d >(a.w * 0.5f + 4.0f))  // close but not hit
-            {
-                if (a.squadId >= 0)
-                    addSuppression(a.squadId, 3.0f);
-            }
-        }
-
-        // Optional: player near-miss, in case you want their behaviour later
-        // float dp = length(player.pos - b.pos);
-        // ...
-    }
-
-
-    // Bullet collision vs map + player + actors
-    for (int bi = 0; bi < (int)bullets.size(); ++bi)
-    {
-        Bullet& b = bullets[bi];
-
-        // Lifetime / map collision
-        if (b.traveled > b.maxRange || bulletHitsSolid(b))
-        {
-            bulletDead[bi] = true;
-            continue;
-        }
-
-        // ----- Hit player ---------------------------------------------------
-        if (playerPresent && player.alive() && areEnemies(b.src, player.team))
-        {
-            float d = length(player.pos - b.pos);
-            if (d < (player.w * 0.5f + 2.f))
-            {
-                HitZone z = HitZone::Torso;
-                resolveHitZone(player, b.pos, z);
-
-                float mult = zoneMultiplier(z) * weaponZoneBias(b.wid, z);
-                int   dealt = (int)std::round((float)b.dmg * mult * gDamageScale);
-
-                player.hp -= dealt;
-                player.lastHitZone = z;
-                player.lastHitTime = gameTimeS;
-                player.lastShotOrigin = b.pos - b.dir * 40.0f;
-
-                // Wounds
-                if (z == HitZone::Legs)
-                    player.legWoundS = std::max(player.legWoundS, 3.0f);
-                if (z == HitZone::ArmL || z == HitZone::ArmR)
-                    player.armWoundS = std::max(player.armWoundS, 3.0f);
-
-                // Bark (throttled)
-                if (barksEnabled && gameTimeS >= player.nextCalloutS)
-                {
-                    barks.push_back({ player.pos, calloutPlayerHurt(z), 1.2f });
-                    player.nextCalloutS = gameTimeS + 0.55f;
-                }
-
-                bulletDead[bi] = true;
-                mission.shotsHit++;
-
-                if (player.hp <= 0)
-                {
-                    corpses.push_back(player.pos);
-                }
-
-                // This bullet is done
-                continue;
-            }
-        }
-
-        // ----- Hit actors ---------------------------------------------------
-        for (int i = 0; i < (int)actors.size(); ++i)
-        {
-            Actor& a = actors[i];
-            if (!a.alive())                 continue;
-            if (!areEnemies(b.src, a.team)) continue;
-
-            float d = length(a.pos - b.pos);
-            if (d < (a.w * 0.5f + 2.f))
-            {
-                HitZone z = HitZone::Torso;
-                resolveHitZone(a, b.pos, z);
-
-                float mult = zoneMultiplier(z) * weaponZoneBias(b.wid, z);
-                int   dealt = (int)std::round((float)b.dmg * mult * gDamageScale);
-
-                a.hp -= dealt;
-                a.lastHitZone = z;
-                a.lastHitTime = gameTimeS;
-                a.lastShotOrigin = b.pos - b.dir * 40.0f;
-
-                // Wounds
-                if (z == HitZone::Legs)
-                    a.legWoundS = std::max(a.legWoundS, 3.0f);
-                if (z == HitZone::ArmL || z == HitZone::ArmR)
-                    a.armWoundS = std::max(a.armWoundS, 3.0f);
-
-                // Player callout when *player side* is the shooter
-                if (barksEnabled && b.src == player.team && gameTimeS >= player.nextCalloutS)
-                {
-                    barks.push_back({ player.pos, calloutPlayerHit(z), 1.0f });
-                    player.nextCalloutS = gameTimeS + 0.45f;
-                }
-
-                a.recentlyHit = true;
-                a.recentlyHitTimer = 3.0f;
-                a.lastShotOrigin = b.pos;
-
-                // Suppression spike on hit
-                if (a.squadId >= 0)
-                    addSuppression(a.squadId, 12.0f);
-
-                bulletDead[bi] = true;
-                mission.shotsHit++;
-
-                if (a.hp <= 0)
-                {
-                    corpses.push_back(a.pos);
-                   
-                    // --- Loot drop: weapon + ammo
-                    {
-                        LootDrop d;
-                        d.pos = a.pos;
-
-                        d.wid = a.weapon.id;
-                        d.srcTeam = (int)a.team;
-
-                        const WeaponDef& wd = weaponDef(d.wid);
-                        d.magAmmo = std::clamp(a.weapon.magAmmo, 0, wd.magSize);
-                        d.ammoLoose = ammoRollForTeam((int)a.team);
-
-                        // New: snapshot full instance (persistent)
-                        d.inst = a.weapon;
-                        ensureWeaponIdentity(d.inst);
-
-                        d.inst.id = d.wid;
-                        d.inst.magAmmo = d.magAmmo;
-                        d.inst.reserveAmmo = d.ammoLoose;
-                        d.hasInst = true;
-
-                        syncLootLegacyFromInst(d);
+            const LootDrop& d = lootDrops[li];
 
-                        lootDrops.push_back(d);
-                    }
+            std::string msg = "E: ";
+            if (d.wid == player.weapon.id) {
+                msg += "Take ammo";
+            }
+            else {
+                msg += "Swap to ";
+                msg += weaponName(d.wid);
+            }
 
-                    mission.enemiesKilled++;
-                }
+            // TODO: replace drawText(...) with your real text function
+            // Example if you have something like drawText:
+            // drawText(msg.c_str(), 10, screenH - 24, {255,255,255,255});
 
-                raiseAlarm(1);
-                break; // stop checking this bullet vs other actors
-            }
+            // If you don’t have a neat place yet, you can even push this into
+            // your existing F1/F2 debug overlay for now as a test.
         }
     }
 
-    // Remove dead bullets
-    std::vector<Bullet> aliveBullets;
-    aliveBullets.reserve(bullets.size());
-    for (int i = 0; i < (int)bullets.size(); ++i)
-    {
-        if (!bulletDead[i])
-            aliveBullets.push_back(bullets[i]);
+
+    // Squad brains
+    for (int i = 0; i < (int)squads.size(); ++i) {
+        updateSquadBrain(i, dt);
     }
-    bullets.swap(aliveBullets);
 
-    // AI update
+    updateBullets(dt);
+
+    // AI update (paths asked for last frame are delivered first)
+    servicePathQueue();
     for (auto& a : actors)
     {
         if (!a.alive()) continue;
@@ -6436,6 +9522,11 @@ void Game::render() {
                 prev = p;
             }
         }
+
+        char line[128];
+        std::snprintf(line, sizeof(line), "pings %d (%d coalesced)  bins %d  hears() %d/tick",
+            (int)sounds.size(), soundsCoalesced, (int)soundGrid.ids.size(), hearTestsLast);
+        drawText(line, 10, cfg::ScreenH - 48, cfg::ColUI);
     }
 
     SDL_RenderSetScale(renderer, 1.f, 1.f);
@@ -6474,3 +9565,1587 @@ void Game::render() {
 
     SDL_RenderPresent(renderer);
 }
+
+// -----------------------------------------------------------
+// Headless benchmarks (Pathfinders --bench, no window needed)
+// -----------------------------------------------------------
+
+// What every bench pass shares: one query stream (fixed seed, so every solver
+// sees exactly the same queries) and the verdict. Passes clear allMatch when an
+// exact check fails; timings are only reported.
+struct Game::BenchRig {
+    Game& game;
+    std::mt19937 qrng{ 1234u };
+    bool allMatch = true;
+
+    struct Query { int s, g; };
+
+    // Exact solvers must match the first solver's path lengths (octile, so ties
+    // between equally short routes don't count); approximate ones (HPA*) report
+    // how much longer they are; None skips the check.
+    enum class Check { Exact, Approx, None };
+    struct Solver {
+        const char* name;
+        std::function<bool(int, int)> fn;
+        Check check;
+    };
+
+    explicit BenchRig(Game& g) : game(g) {}
+
+    int navCell(int c0, int r0, int c1, int r1) {
+        std::uniform_int_distribution<int> dc(c0, c1);
+        std::uniform_int_distribution<int> dr(r0, r1);
+        for (int tries = 0; tries < 1024; ++tries) {
+            int c = dc(qrng);
+            int r = dr(qrng);
+            if (game.isNavWalkable(c, r)) return r * game.map.cols + c;
+        }
+        return -1;
+    }
+
+    std::function<bool(int, int)> call(bool (Game::* fn)(int, int) const) {
+        Game* self = &game;
+        return [self, fn](int s, int g) { return (self->*fn)(s, g); };
+    }
+
+    // Octile length as straight and diagonal step counts: equally short routes
+    // have the same counts, so Exact needs no float tolerance
+    struct Steps { long long straight = -1, diagonal = -1; };
+    Steps pathSteps(const std::vector<int>& cells) const {
+        const int cols = game.map.cols;
+        Steps st{ 0, 0 };
+        for (size_t i = 1; i < cells.size(); ++i) {
+            int dx = std::abs(cells[i] % cols - cells[i - 1] % cols);
+            int dy = std::abs(cells[i] / cols - cells[i - 1] / cols);
+            st.straight += std::max(dx, dy) - std::min(dx, dy);
+            st.diagonal += std::min(dx, dy);
+        }
+        return st;
+    }
+
+    std::vector<Query> queries(int n, bool crossMap) {
+        const Map& map = game.map;
+        std::vector<Query> qs;
+        const int m = 2;
+        const int q = map.cols / 4;
+        for (int i = 0; i < n; ++i) {
+            Query qu{ -1, -1 };
+            if (crossMap) {
+                // Opposite corners, like sweep squads crossing the whole map
+                qu.s = navCell(m, m, m + q, m + q);
+                qu.g = navCell(map.cols - 1 - m - q, map.rows - 1 - m - q,
+                    map.cols - 1 - m, map.rows - 1 - m);
+            }
+            else {
+                qu.s = navCell(m, m, map.cols - 1 - m, map.rows - 1 - m);
+                qu.g = navCell(m, m, map.cols - 1 - m, map.rows - 1 - m);
+            }
+            if (qu.s >= 0 && qu.g >= 0) qs.push_back(qu);
+        }
+        return qs;
+    }
+
+    void runSet(const char* label, const std::vector<Query>& qs, const std::vector<Solver>& solvers, int rounds) {
+        std::printf("[bench] %s (%d queries x%d)\n", label, (int)qs.size(), rounds);
+
+        std::vector<Steps> refSteps;
+        for (size_t si = 0; si < solvers.size(); ++si) {
+            std::vector<Steps> steps(qs.size());
+            long long expanded = 0;
+
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (int round = 0; round < rounds; ++round) {
+                for (size_t i = 0; i < qs.size(); ++i) {
+                    bool ok = solvers[si].fn(qs[i].s, qs[i].g);
+                    expanded += game.pathWs.expanded;
+                    steps[i] = ok ? pathSteps(game.pathWs.cells) : Steps{};
+                }
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            double usPerQuery = qs.empty() ? 0.0 : ms * 1000.0 / double(qs.size() * rounds);
+
+            char verdict[64] = "";
+            if (si == 0) {
+                refSteps = steps;
+            }
+            else if (solvers[si].check == Check::Exact) {
+                bool same = true;
+                for (size_t i = 0; i < qs.size(); ++i) {
+                    same &= steps[i].straight == refSteps[i].straight && steps[i].diagonal == refSteps[i].diagonal;
+                }
+                std::snprintf(verdict, sizeof(verdict), same ? "  paths match" : "  PATH LENGTH MISMATCH");
+                if (!same) allMatch = false;
+            }
+            else if (solvers[si].check == Check::Approx) {
+                auto len = [](const Steps& st) { return double(st.straight) + 1.41421356 * double(st.diagonal); };
+                double sumRef = 0.0, sumOurs = 0.0;
+                bool sameFound = true;
+                for (size_t i = 0; i < qs.size(); ++i) {
+                    if ((steps[i].straight < 0) != (refSteps[i].straight < 0)) sameFound = false;
+                    if (steps[i].straight < 0 || refSteps[i].straight < 0) continue;
+                    sumRef += len(refSteps[i]);
+                    sumOurs += len(steps[i]);
+                }
+                double extra = sumRef > 0.0 ? 100.0 * (sumOurs - sumRef) / sumRef : 0.0;
+                std::snprintf(verdict, sizeof(verdict), sameFound ? "  +%.1f%% length" : "  REACHABILITY MISMATCH", extra);
+                if (!sameFound) allMatch = false;
+            }
+
+            std::printf("  %-14s %9.3f ms %9.1f us/q  expanded %9lld  %10.1f nodes/ms%s\n",
+                solvers[si].name, ms, usPerQuery, expanded,
+                ms > 0.0 ? (double)expanded / ms : 0.0, verdict);
+        }
+    }
+};
+
+int Game::runBenchmarks() {
+    rng().seed(1234u);   // same maps every run
+    initWorld();
+    pathCacheEnabled = false;   // timings below are raw searches unless stated
+
+    BenchRig rig(*this);
+
+    benchPathSolvers(rig);
+    benchPathFollowing(rig);
+    benchPathQueue(rig);
+    benchPathRepair(rig);
+    benchPvs(rig);
+    benchLargeNav(rig);
+    benchLos(rig);
+    benchTrunks(rig);
+    benchLoot(rig);
+    benchFoliage(rig);
+    benchPerception(rig);
+    benchActorGrid(rig);
+    benchHearing(rig);
+    benchBullets(rig);
+    benchPerceptionLod(rig);
+    std::printf("================================\n");
+
+    return rig.allMatch ? 0 : 1;
+}
+
+// Every solver on the sandbox map, then with the mission compound stamped in
+void Game::benchPathSolvers(BenchRig& rig) {
+    const std::vector<BenchRig::Solver> smallSolvers = {
+        { "heap A*",      rig.call(&Game::searchGridPath),          BenchRig::Check::Exact },
+        { "old 4-conn A*", rig.call(&Game::searchGridPathReference), BenchRig::Check::None },   // timing only
+        { "JPS",          rig.call(&Game::searchJumpPoint),         BenchRig::Check::Exact },
+        { "HPA* full",    rig.call(&Game::searchHierarchical),      BenchRig::Check::Approx },
+    };
+
+    std::printf("=== PATH BENCH (%dx%d) ===\n", map.cols, map.rows);
+    rig.runSet("sandbox random", rig.queries(200, false), smallSolvers, 3);
+    rig.runSet("sandbox cross-map", rig.queries(50, true), smallSolvers, 3);
+
+    // Mission-style compound: the larger prefab stamped in the middle (startMission variant 2)
+    {
+        const Prefab& p = prefabs[1];
+        int c0 = (map.cols - p.w) / 2, r0 = (map.rows - p.h) / 2;
+        for (int y = 0; y < p.h; ++y)
+            for (int x = 0; x < p.w; ++x) {
+                Tile t = p.data[y * p.w + x];
+                if (t != Tile::Land) map.set(c0 + x, r0 + y, t);
+            }
+        applyTreesClump(map, 8, 4);
+        rebuildFoliage();
+        rebuildNavData();
+    }
+    rig.runSet("compound random", rig.queries(200, false), smallSolvers, 3);
+    rig.runSet("compound cross-map", rig.queries(50, true), smallSolvers, 3);
+}
+
+// What paths cost the pawns walking them: pull, clearance, shared fields, cache
+void Game::benchPathFollowing(BenchRig& rig) {
+    // How much walking the waypoint pull saves the path follower
+    {
+        std::vector<BenchRig::Query> qs = rig.queries(200, false);
+        std::vector<Vec2> pulled;
+        long long tiles = 0, points = 0;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (const BenchRig::Query& q : qs) {
+            if (!searchGridPath(q.s, q.g)) continue;
+            stringPull(pathWs.cells, pulled);
+            tiles += (long long)pathWs.cells.size();
+            points += (long long)pulled.size();
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        std::printf("[bench] string pull: %lld tiles -> %lld waypoints (search + pull %.3f ms)\n",
+            tiles, points, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+
+    // Clearance-aware paths: how many path tiles still rub against something solid
+    {
+        std::vector<BenchRig::Query> qs = rig.queries(200, false);
+        auto hugging = [&](int minClear, long long& tight, long long& tiles) {
+            pathMinClearance = minClear;
+            Actor a;
+            tight = tiles = 0;
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (const BenchRig::Query& q : qs) {
+                if (!buildPath(tileCenterOf(q.s), tileCenterOf(q.g), a)) continue;
+                for (int cell : pathWs.cells) {
+                    tight += clearanceAt(cell % map.cols, cell / map.cols) < 2 ? 1 : 0;
+                }
+                tiles += (long long)pathWs.cells.size();
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::milli>(t1 - t0).count();
+            };
+        long long tightPlain, tilesPlain, tightRoomy, tilesRoomy;
+        double plainMs = hugging(1, tightPlain, tilesPlain);
+        double roomyMs = hugging(cfg::PathMinClearance, tightRoomy, tilesRoomy);
+        pathMinClearance = cfg::PathMinClearance;
+        std::printf("[bench] wall-hugging path tiles: plain %lld/%lld (%.3f ms) | clearance %d: %lld/%lld (%.3f ms)\n",
+            tightPlain, tilesPlain, plainMs, cfg::PathMinClearance, tightRoomy, tilesRoomy, roomyMs);
+    }
+
+    // A squad-sized group converging on one contact point: one private path each
+    // vs. one shared field plus a per-tile downhill step for everybody.
+    {
+        const int followers = 16;
+        int goal = rig.navCell(map.cols / 2 - 4, map.rows / 2 - 4, map.cols / 2 + 4, map.rows / 2 + 4);
+        std::vector<int> starts;
+        for (int i = 0; i < followers; ++i) {
+            int s = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+            if (s >= 0) starts.push_back(s);
+        }
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        long long pathTiles = 0;
+        for (int s : starts) {
+            if (searchGridPath(s, goal)) pathTiles += (long long)pathWs.cells.size();
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        flowFields.clear();
+        const FlowField& field = flowFieldTo(goal);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        long long flowTiles = 0;
+        for (int s : starts) {
+            Vec2 p{ (s % map.cols + 0.5f) * cfg::TileSize, (s / map.cols + 0.5f) * cfg::TileSize };
+            Vec2 dir;
+            for (int step = 0; step < map.cols * map.rows && flowDirection(field, p, dir); ++step) {
+                p = p + dir * float(cfg::TileSize);   // one tile per step
+                ++flowTiles;
+            }
+        }
+        auto t3 = std::chrono::high_resolution_clock::now();
+
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+        std::printf("[bench] %d followers, one goal: private A* %.3f ms (%lld tiles) | flow field build %.3f ms + walk %.3f ms (%lld tiles)\n",
+            (int)starts.size(), ms(t0, t1), pathTiles, ms(t1, t2), ms(t2, t3), flowTiles);
+    }
+
+    // Patrol loops: squads cycle fixed checkpoints and repath partway along,
+    // so the same tile pairs (and tails of them) come up again and again.
+    {
+        const int checkpoints = 8;
+        const int walkers = 6;
+        const int laps = 10;
+        std::vector<int> cps;
+        for (int i = 0; i < checkpoints; ++i) {
+            int c = rig.navCell(4, 4, map.cols - 5, map.rows - 5);
+            if (c >= 0) cps.push_back(c);
+        }
+
+        auto patrol = [&](bool cached) {
+            pathCacheEnabled = cached;
+            pathCache.clear();
+            pathCacheHits = pathCacheSuffixHits = pathCacheMisses = 0;
+            Actor a;
+            int queries = 0;
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (int lap = 0; lap < laps; ++lap) {
+                for (int w = 0; w < walkers; ++w) {
+                    for (int i = 0; i < (int)cps.size(); ++i) {
+                        int from = cps[(i + w) % cps.size()];
+                        int to = cps[(i + w + 1) % cps.size()];
+                        if (!buildPath(tileCenterOf(from), tileCenterOf(to), a)) continue;
+                        ++queries;
+                        // repathTimer fired a third of the way along
+                        Vec2 mid = a.path[a.path.size() / 3];
+                        buildPath(mid, tileCenterOf(to), a);
+                        ++queries;
+                    }
+                }
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+            return std::make_pair(queries, std::chrono::duration<double, std::milli>(t1 - t0).count());
+            };
+
+        auto raw = patrol(false);
+        auto hit = patrol(true);
+        std::printf("[bench] patrol loops, %d queries: uncached %.3f ms | cached %.3f ms (%d exact, %d suffix, %d miss)\n",
+            raw.first, raw.second, hit.second, pathCacheHits, pathCacheSuffixHits, pathCacheMisses);
+        pathCacheEnabled = false;
+    }
+}
+
+// Frame-budgeted path requests: bursts and aging
+void Game::benchPathQueue(BenchRig& rig) {
+    // Alarm burst: everybody asks for a path on the same frame. The queue spreads
+    // the searches over frames instead of stalling one.
+    {
+        const int burst = 64;
+        PathMode keepMode = pathMode;
+        pathMode = PathMode::AStar;   // worst case per search
+        actors.clear();
+        pathQueue.clear();
+        for (int i = 0; i < burst; ++i) {
+            int s = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+            int g = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+            if (s < 0 || g < 0) continue;
+            Actor a;
+            a.hp = a.hpMax = 1;
+            a.pos = Vec2{ (s % map.cols + 0.5f) * cfg::TileSize, (s / map.cols + 0.5f) * cfg::TileSize };
+            actors.push_back(a);
+            actors.back().orderPos = Vec2{ (g % map.cols + 0.5f) * cfg::TileSize, (g / map.cols + 0.5f) * cfg::TileSize };
+        }
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (Actor& a : actors) buildPath(a.pos, a.orderPos, a);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        double syncMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        for (Actor& a : actors) {
+            clearPath(a);
+            requestPath(a, a.orderPos);
+            requestPath(a, a.orderPos);   // same goal again: deduped
+        }
+        int frames = 0;
+        double worstMs = 0.0;
+        while (!pathQueue.empty()) {
+            auto f0 = std::chrono::high_resolution_clock::now();
+            servicePathQueue();
+            auto f1 = std::chrono::high_resolution_clock::now();
+            worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(f1 - f0).count());
+            ++frames;
+        }
+        std::printf("[bench] alarm burst, %d A* requests: one frame %.3f ms synchronous | queued: %d frames, worst frame %.3f ms (budget %d us, %d deduped)\n",
+            (int)actors.size(), syncMs, frames, worstMs, cfg::PathBudgetUs, pathReqDeduped);
+
+        actors.clear();
+        pathMode = keepMode;
+    }
+
+    // Queue aging: a far request is overtaken by a near one asked soon after, but
+    // not by one asked after its wait (distance / PathQueueAgeTilesPerS) is up
+    {
+        bool hadPlayer = playerPresent;
+        Vec2 playerWas = player.pos;
+        float timeWas = gameTimeS;
+        playerPresent = true;
+        player.pos = tileCenterOf(2 * map.cols + 2);
+        actors.assign(2, Actor{});
+        for (Actor& a : actors) a.hp = a.hpMax = 1;
+        actors[0].pos = tileCenterOf((map.rows - 3) * map.cols + map.cols - 3);   // far
+        actors[1].pos = player.pos;                                              // near
+        const float farWaitS = length(actors[0].pos - player.pos) / (cfg::PathQueueAgeTilesPerS * cfg::TileSize);
+
+        auto firstServed = [&](float laterS) {
+            pathQueue.clear();
+            for (Actor& a : actors) a.pathTicket = 0;
+            gameTimeS = timeWas;
+            requestPath(actors[0], actors[1].pos);
+            gameTimeS = timeWas + laterS;
+            requestPath(actors[1], actors[0].pos);
+            return pathQueue.front().actor;
+            };
+        const bool nearFirst = firstServed(farWaitS * 0.5f) == 1;
+        const bool farFirst = firstServed(farWaitS + 0.1f) == 0;
+        if (!nearFirst || !farFirst) rig.allMatch = false;
+        std::printf("[bench] path queue aging: far request (%.2f s max wait) %s\n", farWaitS,
+            nearFirst && farFirst ? "overtaken early, served first once its wait is up" : "AGING MISMATCH");
+
+        pathQueue.clear();
+        actors.clear();
+        gameTimeS = timeWas;
+        player.pos = playerWas;
+        playerPresent = hadPlayer;
+    }
+}
+
+// Paths against a changing or sealed-off map
+void Game::benchPathRepair(BenchRig& rig) {
+    // Paint walls across live paths: splice repair vs replanning every hit path
+    {
+        const int walkers = 48;
+        const int edits = 24;
+        actors.clear();
+        pathQueue.clear();
+        for (int i = 0; i < walkers; ++i) {
+            int s = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+            int g = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+            if (s < 0 || g < 0) continue;
+            Actor a;
+            a.hp = a.hpMax = 1;
+            a.pos = tileCenterOf(s);
+            if (buildPath(a.pos, tileCenterOf(g), a)) actors.push_back(a);
+        }
+
+        int repaired = 0, requeued = 0, hits = 0;
+        double repairMs = 0.0, replanMs = 0.0;
+        for (int e = 0; e < edits && !actors.empty(); ++e) {
+            // Block a tile halfway along the middle leg of somebody's path
+            const Actor& victim = actors[irand(0, (int)actors.size() - 1)];
+            if (victim.path.size() < 2) continue;
+            size_t k = (victim.path.size() - 1) / 2;
+            int cell = tileIndexAt((victim.path[k] + victim.path[k + 1]) * 0.5f);
+            if (cell == tileIndexAt(victim.path.front()) || cell == tileIndexAt(victim.path.back())) continue;
+            map.set(cell % map.cols, cell / map.cols, Tile::Wall);
+            onNavTileChanged(cell % map.cols, cell / map.cols);
+
+            // What a full replan of every crossing path would cost
+            std::vector<Actor> copies;
+            for (const Actor& a : actors) {
+                if (firstBlockedSegment(a, cell) >= 0) copies.push_back(a);
+            }
+            hits += (int)copies.size();
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (Actor& a : copies) buildPath(a.pos, a.path.back(), a);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            int q = 0;
+            repaired += repairPathsAfterBlock(cell % map.cols, cell / map.cols, q);
+            auto t2 = std::chrono::high_resolution_clock::now();
+            requeued += q;
+            replanMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            repairMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+        }
+
+        // Every patched path must still be walkable end to end, pawn-wide
+        bool valid = true;
+        for (const Actor& a : actors) {
+            if (a.path.empty() || a.pathIndex < 0) continue;
+            Vec2 prev = a.pos;
+            for (int i = a.pathIndex; i < (int)a.path.size(); ++i) {
+                if (!navLineClear(prev, a.path[i], cfg::PawnSize * 0.75f)) valid = false;
+                prev = a.path[i];
+            }
+        }
+        if (!valid) rig.allMatch = false;
+        std::printf("[bench] paint %d walls over %d live paths: %d paths hit, %d patched (%.3f ms), %d queued; full replans would take %.3f ms; %s\n",
+            edits, (int)actors.size(), hits, repaired, repairMs, requeued, replanMs,
+            valid ? "patched paths valid" : "INVALID PATCHED PATH");
+
+        actors.clear();
+        pathQueue.clear();
+    }
+
+    // Goals nobody can reach: a walled-in pocket. Without the component labels
+    // every one of these searches floods the whole map before giving up.
+    {
+        const int pc = map.cols / 2, pr = map.rows / 2;
+        for (int y = -2; y <= 2; ++y)
+            for (int x = -2; x <= 2; ++x) {
+                bool ring = std::abs(x) == 2 || std::abs(y) == 2;
+                map.set(pc + x, pr + y, ring ? Tile::Wall : Tile::Land);
+                onNavTileChanged(pc + x, pr + y);
+            }
+        const int inside = pr * map.cols + pc;
+
+        std::vector<int> starts;
+        for (int i = 0; i < 50; ++i) {
+            int s = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+            if (s >= 0 && navComp[s] == navMainComp) starts.push_back(s);
+        }
+
+        PathMode keepMode = pathMode;
+        pathMode = PathMode::AStar;
+        int found = 0;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int s : starts) found += searchGridPath(s, inside) ? 1 : 0;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        Actor a;
+        for (int s : starts) found += buildPath(tileCenterOf(s), tileCenterOf(inside), a) ? 1 : 0;
+        auto t2 = std::chrono::high_resolution_clock::now();
+        pathMode = keepMode;
+
+        if (found != 0) rig.allMatch = false;
+        std::printf("[bench] %d sealed-goal queries: full search %.3f ms | component reject %.3f ms; %s\n",
+            (int)starts.size(), std::chrono::duration<double, std::milli>(t1 - t0).count(),
+            std::chrono::duration<double, std::milli>(t2 - t1).count(),
+            found == 0 ? "none reached" : "SEALED GOAL REACHED");
+    }
+}
+
+// Visibility table: build, patch after paint, and what a lookup saves over a ray
+void Game::benchPvs(BenchRig& rig) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    rebuildPvs();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const double buildMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    const int edits = 20;
+    double patchMs = 0.0;
+    for (int e = 0; e < edits; ++e) {
+        int c = irand(2, map.cols - 3), r = irand(2, map.rows - 3);
+        map.set(c, r, map.at(c, r) == Tile::Wall ? Tile::Land : Tile::Wall);
+        auto p0 = std::chrono::high_resolution_clock::now();
+        updatePvs(c, r);
+        auto p1 = std::chrono::high_resolution_clock::now();
+        patchMs += std::chrono::duration<double, std::milli>(p1 - p0).count();
+    }
+    std::vector<uint64_t> patched = pvs, patchedWide = pvsWide;
+    rebuildPvs();
+    bool same = (patched == pvs && patchedWide == pvsWide);
+    if (!same) rig.allMatch = false;
+
+    // Actor-to-actor style queries inside vision range
+    std::vector<Vec2> from, to;
+    for (int i = 0; i < 20000; ++i) {
+        int s = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+        if (s < 0) continue;
+        Vec2 a = tileCenterOf(s);
+        float ang = frand(0.0f, 6.28318f), len = frand(1.0f, 12.0f) * cfg::TileSize;
+        from.push_back(a);
+        to.push_back(tileCenterOf(tileIndexAt(a + Vec2{ std::cos(ang) * len, std::sin(ang) * len }) < 0 ? s
+            : tileIndexAt(a + Vec2{ std::cos(ang) * len, std::sin(ang) * len })));
+    }
+    int rayHits = 0, pvsHits = 0, disagree = 0;
+    auto q0 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < from.size(); ++i) rayHits += losClear(from[i], to[i]) ? 1 : 0;
+    auto q1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < from.size(); ++i) pvsHits += losVisible(from[i], to[i]) ? 1 : 0;
+    auto q2 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < from.size(); ++i) disagree += losClear(from[i], to[i]) != losVisible(from[i], to[i]) ? 1 : 0;
+    if (disagree != 0) rig.allMatch = false;
+
+    auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    std::printf("[bench] PVS r=%d: build %.3f ms, %.1f KB | %d paint patches %.3f ms avg, %s\n",
+        cfg::PvsRadius, buildMs, (pvs.size() + pvsWide.size()) * sizeof(uint64_t) / 1024.0, edits, patchMs / edits,
+        same ? "match full rebuild" : "PVS MISMATCH");
+    std::printf("[bench] PVS %d centre-to-centre queries: raycast %.3f ms (%d clear) | table %.3f ms (%d clear)%s\n",
+        (int)from.size(), ms(q0, q1), rayHits, ms(q1, q2), pvsHits, disagree == 0 ? "" : " TABLE DISAGREES");
+
+    // Pawns stand anywhere in a tile, not on its centre. A 0 bit may hide a
+    // pawn the exact ray would see past a corner; a 1 bit must never show one
+    // through a wall.
+    int offRay = 0, offTable = 0, offMissed = 0, offExtra = 0;
+    const float jitter = cfg::TileSize * 0.45f;
+    for (size_t i = 0; i < from.size(); ++i) {
+        Vec2 fa = from[i] + Vec2{ frand(-jitter, jitter), frand(-jitter, jitter) };
+        Vec2 fb = to[i] + Vec2{ frand(-jitter, jitter), frand(-jitter, jitter) };
+        bool ray = losClear(fa, fb), table = losVisible(fa, fb);
+        offRay += ray ? 1 : 0;
+        offTable += table ? 1 : 0;
+        offMissed += (ray && !table) ? 1 : 0;
+        offExtra += (!ray && table) ? 1 : 0;
+    }
+    if (offExtra != 0) rig.allMatch = false;
+    std::printf("[bench] PVS %d off-centre queries: raycast %d clear | table %d clear (%d hidden, %d seen through)%s\n",
+        (int)from.size(), offRay, offTable, offMissed, offExtra, offExtra == 0 ? "" : " TABLE SEES THROUGH WALLS");
+}
+
+// Large map: what HPA* is for. The linear-scan reference is far too slow here.
+void Game::benchLargeNav(BenchRig& rig) {
+    // What buildPath does in HPA* mode: entrance route + the first few legs
+    Actor lazyActor;
+    auto hpaLazy = [&](int s, int g) {
+        if (!searchAbstract(s, g)) return false;
+        lazyActor.navRoute.assign(nav.route.begin(), nav.route.end());
+        lazyActor.navRouteIndex = 0;
+        return refineNavLegs(lazyActor);
+        };
+
+    const int n = 512;
+    map.init(n, n);
+    for (int r = 0; r < n; ++r)
+        for (int c = 0; c < n; ++c)
+            map.set(c, r, (r == 0 || c == 0 || r == n - 1 || c == n - 1) ? Tile::Water : Tile::Land);
+    applyTreesClump(map, 400, 5);
+    applyTreesSparse(map, 0.02f);
+    for (int i = 0; i < 600; ++i) {
+        // Short wall runs, like compound walls scattered about
+        int c = irand(2, n - 3), r = irand(2, n - 3);
+        int len = irand(4, 20);
+        bool horiz = irand(0, 1) == 0;
+        for (int j = 0; j < len; ++j) {
+            int x = horiz ? c + j : c;
+            int y = horiz ? r : r + j;
+            if (x > 0 && y > 0 && x < n - 1 && y < n - 1) map.set(x, y, Tile::Wall);
+        }
+    }
+
+    rebuildFoliage();
+    auto t0 = std::chrono::high_resolution_clock::now();
+    rebuildNavData();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    rebuildPvs();   // too big for a table: LOS raycasts from here on
+
+    int entrances = 0;
+    for (const NavCluster& cl : nav.clusters) entrances += (int)cl.cells.size();
+    std::printf("=== PATH BENCH (%dx%d) ===\n", map.cols, map.rows);
+    std::printf("[bench] HPA* graph: %d chunks, %d entrances, full build %.3f ms\n",
+        (int)nav.clusters.size(), entrances,
+        std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+    // Local rebuild cost, as when painting one tile
+    const int edits = 200;
+    t0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < edits; ++i) {
+        int c = irand(1, n - 2), r = irand(1, n - 2);
+        Tile before = map.at(c, r);
+        map.set(c, r, before == Tile::Land ? Tile::Wall : Tile::Land);
+        onNavTileChanged(c, r);
+        map.set(c, r, before);
+        onNavTileChanged(c, r);
+    }
+    t1 = std::chrono::high_resolution_clock::now();
+    std::printf("[bench] HPA* local rebuild: %.1f us per painted tile\n",
+        std::chrono::duration<double, std::micro>(t1 - t0).count() / double(edits * 2));
+
+    // The incrementally kept component labels must split the map exactly like a fresh pass
+    {
+        std::vector<int> kept = navComp;
+        rebuildNavComponents();
+        std::unordered_map<int, int> fwd, back;
+        bool same = true;
+        for (size_t i = 0; i < kept.size() && same; ++i) {
+            if ((kept[i] < 0) != (navComp[i] < 0)) { same = false; break; }
+            if (kept[i] < 0) continue;
+            auto f = fwd.emplace(kept[i], navComp[i]).first;
+            auto b = back.emplace(navComp[i], kept[i]).first;
+            if (f->second != navComp[i] || b->second != kept[i]) same = false;
+        }
+        if (!same) rig.allMatch = false;
+        std::printf("[bench] nav components after %d edits: %s\n", edits * 2,
+            same ? "match full relabel" : "COMPONENT MISMATCH");
+    }
+    {
+        std::vector<uint8_t> kept = navClearance;
+        t0 = std::chrono::high_resolution_clock::now();
+        rebuildClearance();
+        t1 = std::chrono::high_resolution_clock::now();
+        bool same = (kept == navClearance);
+        if (!same) rig.allMatch = false;
+        std::printf("[bench] clearance after %d edits: %s (full rebuild %.3f ms)\n", edits * 2,
+            same ? "matches full rebuild" : "CLEARANCE MISMATCH",
+            std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+
+    const std::vector<BenchRig::Solver> largeSolvers = {
+        { "heap A*",   rig.call(&Game::searchGridPath),     BenchRig::Check::Exact },
+        { "JPS",       rig.call(&Game::searchJumpPoint),    BenchRig::Check::Exact },
+        { "HPA* full", rig.call(&Game::searchHierarchical), BenchRig::Check::Approx },
+        { "HPA* lazy", hpaLazy,                         BenchRig::Check::None },
+    };
+    rig.runSet("large random", rig.queries(100, false), largeSolvers, 1);
+    rig.runSet("large cross-map", rig.queries(50, true), largeSolvers, 1);
+}
+
+// LOS: the old fixed 32 samples vs the exact tile walk. Vision-range rays
+// (up to 10 tiles) are the common case; long ones are where sampling breaks.
+void Game::benchLos(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+
+    auto losBench = [&](float maxTiles) {
+        const int rays = 20000;
+        const int fanout = 16;   // targets per eye for the batched form
+        std::vector<Vec2> eyes, targets;
+        for (int i = 0; i < rays / fanout; ++i) {
+            int e = rig.navCell(60, 60, n - 61, n - 61);
+            if (e < 0) continue;
+            Vec2 eye = tileCenterOf(e) + Vec2{ frand(-12.0f, 12.0f), frand(-12.0f, 12.0f) };
+            for (int k = 0; k < fanout; ++k) {
+                float ang = frand(0.0f, 6.28318f);
+                float len = frand(1.0f, maxTiles) * cfg::TileSize;
+                eyes.push_back(eye);
+                targets.push_back(eye + Vec2{ std::cos(ang) * len, std::sin(ang) * len });
+            }
+        }
+        const int count = (int)targets.size();
+
+        auto opaque = [&](int c, int r, long long& reads) {
+            ++reads;
+            Tile t = map.at(c, r);
+            return t == Tile::Wall || t == Tile::Water;
+            };
+        // The old losClear, with a read counter
+        auto sampled = [&](const Vec2& a, const Vec2& b, long long& reads) {
+            Vec2 d = b - a;
+            for (int i = 1; i <= 32; ++i) {
+                Vec2 p = a + d * (float(i) / 32.0f);
+                if (opaque(int(p.x / cfg::TileSize), int(p.y / cfg::TileSize), reads)) return false;
+            }
+            return true;
+            };
+
+        long long sampledReads = 0, ddaReads = 0, scratch = 0;
+        for (int i = 0; i < count; ++i) {
+            sampled(eyes[i], targets[i], sampledReads);
+            traverseTiles(eyes[i], targets[i], [&](int c, int r) { return !opaque(c, r, ddaReads); });
+        }
+
+        std::vector<char> oldClear(count), newClear(count);
+        bool batchOut[fanout];
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < count; ++i) oldClear[i] = sampled(eyes[i], targets[i], scratch);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < count; ++i) newClear[i] = losClear(eyes[i], targets[i]);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        bool batchSame = true;
+        for (int i = 0; i + fanout <= count; i += fanout) {
+            losClearBatch(eyes[i], &targets[i], fanout, batchOut);
+            for (int k = 0; k < fanout; ++k) batchSame &= (batchOut[k] == (bool)newClear[i + k]);
+        }
+        auto t3 = std::chrono::high_resolution_clock::now();
+
+        int seeThrough = 0;
+        for (int i = 0; i < count; ++i) seeThrough += (oldClear[i] && !newClear[i]) ? 1 : 0;
+        if (!batchSame) rig.allMatch = false;
+
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+        std::printf("[bench] LOS %d rays <= %.0f tiles: 32 samples %.3f ms (%.1f reads/ray, %d through walls) | tile walk %.3f ms (%.1f reads/ray) | batched x%d %.3f ms%s\n",
+            count, maxTiles, ms(t0, t1), double(sampledReads) / count, seeThrough,
+            ms(t1, t2), double(ddaReads) / count, fanout, ms(t2, t3), batchSame ? "" : " BATCH MISMATCH");
+        };
+    losBench(10.0f);
+    losBench(60.0f);
+
+    // Exact corner ties: eyes on tile corners looking along diagonals, so every
+    // step is a tie. Both directions and the batch must agree, and no walk may
+    // visit a tile past its target's.
+    {
+        int checked = 0, differ = 0, overrun = 0;
+        for (int i = 0; i < 2000; ++i) {
+            int s = rig.navCell(2, 2, map.cols - 3, map.rows - 3);
+            if (s < 0) continue;
+            const Vec2 a{ float(s % map.cols) * cfg::TileSize, float(s / map.cols) * cfg::TileSize };
+            const int k = irand(1, 8);
+            const int sx = irand(0, 1) ? 1 : -1, sy = irand(0, 1) ? 1 : -1;
+            const Vec2 b = a + Vec2{ float(sx * k) * cfg::TileSize, float(sy * k) * cfg::TileSize };
+            bool ab = losClear(a, b), ba = losClear(b, a), batchAB = false, batchBA = false;
+            losClearBatch(a, &b, 1, &batchAB);
+            losClearBatch(b, &a, 1, &batchBA);
+            differ += (ab != ba || ab != batchAB || ab != batchBA) ? 1 : 0;
+
+            const int ec = (int)std::floor(b.x / cfg::TileSize), er = (int)std::floor(b.y / cfg::TileSize);
+            const int ac = (int)std::floor(a.x / cfg::TileSize), ar = (int)std::floor(a.y / cfg::TileSize);
+            traverseTiles(a, b, [&](int c, int r) {
+                if ((c - ac) * (c - ec) > 0 || (r - ar) * (r - er) > 0) ++overrun;   // outside the a-b tile box
+                return true;
+                });
+            ++checked;
+        }
+        if (differ != 0 || overrun != 0) rig.allMatch = false;
+        std::printf("[bench] LOS corner ties, %d rays: %d direction/batch disagreements, %d tiles walked past the target%s\n",
+            checked, differ, overrun, differ == 0 && overrun == 0 ? "" : " LOS TIE MISMATCH");
+    }
+}
+
+// Trunk collision: the per-tile buckets vs checking every trunk on the map
+void Game::benchTrunks(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+    const float T = (float)cfg::TileSize;
+    std::vector<SDL_FRect> rects;
+    for (int i = 0; i < 4000; ++i) {
+        rects.push_back(rectFrom(Vec2{ frand(2.0f, n - 2.0f) * T, frand(2.0f, n - 2.0f) * T },
+            cfg::PawnSize, cfg::PawnSize));
+    }
+    auto allTrunks = [&](const SDL_FRect& r) {
+        for (const auto& t : trunks) {
+            float half = t.dia * 0.5f;
+            SDL_FRect tr{ t.center.x - half, t.center.y - half, t.dia, t.dia };
+            if (SDL_HasIntersectionF(&tr, &r)) return true;
+        }
+        return false;
+        };
+    int oldHits = 0, newHits = 0;
+    bool same = true;
+    auto k0 = std::chrono::high_resolution_clock::now();
+    for (const SDL_FRect& r : rects) oldHits += allTrunks(r) ? 1 : 0;
+    auto k1 = std::chrono::high_resolution_clock::now();
+    for (const SDL_FRect& r : rects) newHits += collideSolid(r) ? 1 : 0;
+    auto k2 = std::chrono::high_resolution_clock::now();
+    for (const SDL_FRect& r : rects) {
+        bool tiles = false;
+        for (int rr = int(std::floor(r.y / T)); rr <= int(std::floor((r.y + r.h) / T)); ++rr)
+            for (int cc = int(std::floor(r.x / T)); cc <= int(std::floor((r.x + r.w) / T)); ++cc)
+                tiles |= map.at(cc, rr) == Tile::Wall || map.at(cc, rr) == Tile::Water;
+        same &= collideSolid(r) == (tiles || allTrunks(r));
+    }
+    if (!same) rig.allMatch = false;
+    std::printf("[bench] trunk collision, %d rects, %d trunks: every trunk %.3f ms (%d trunk hits) | tile buckets %.3f ms (%d solid hits)%s\n",
+        (int)rects.size(), (int)trunks.size(),
+        std::chrono::duration<double, std::milli>(k1 - k0).count(), oldHits,
+        std::chrono::duration<double, std::milli>(k2 - k1).count(), newHits,
+        same ? "" : " TRUNK MISMATCH");
+}
+
+// Loot: nearest-drop queries on a long session's worth of drops, then the
+// per-tick cleanup (taken drops out, cap enforced, merges on add)
+void Game::benchLoot(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+    const float T = (float)cfg::TileSize;
+    lootDrops.clear();
+    for (int i = 0; i < 3000; ++i) {
+        LootDrop d;
+        d.pos = Vec2{ frand(2.0f, n - 2.0f) * T, frand(2.0f, n - 2.0f) * T };
+        d.wid = WeaponId::M1911;
+        d.ammoLoose = 10;
+        d.taken = (i % 3) == 0;
+        lootDrops.push_back(d);
+    }
+    lootIndex.dirty = true;
+    std::vector<Vec2> probes;
+    for (int i = 0; i < 20000; ++i) probes.push_back(lootDrops[i % lootDrops.size()].pos + Vec2{ frand(-30.0f, 30.0f), frand(-30.0f, 30.0f) });
+
+    auto scan = [&](const Vec2& p, float maxDist) {
+        float best2 = maxDist * maxDist;
+        int bestIdx = -1;
+        for (int i = 0; i < (int)lootDrops.size(); ++i) {
+            if (lootDrops[i].taken) continue;
+            float d2 = dist2(lootDrops[i].pos, p);
+            if (d2 < best2) { best2 = d2; bestIdx = i; }
+        }
+        return bestIdx;
+        };
+    std::vector<int> scanned(probes.size());
+    auto q0 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < probes.size(); ++i) scanned[i] = scan(probes[i], lootRadius);
+    auto q1 = std::chrono::high_resolution_clock::now();
+    int found = 0;
+    bool same = true;
+    for (size_t i = 0; i < probes.size(); ++i) {
+        int li = findNearestLoot(probes[i], lootRadius);
+        found += li >= 0 ? 1 : 0;
+        same &= li == scanned[i];
+    }
+    auto q2 = std::chrono::high_resolution_clock::now();
+
+    // Plain ammo merges; a weapon instance dropped next to it, or next to
+    // another instance with its own uid, stays its own drop
+    int before = (int)lootDrops.size();
+    LootDrop dup = lootDrops[1];   // untaken
+    addLootDrop(dup);
+    bool merged = (int)lootDrops.size() == before && !lootDrops[1].hasInst && lootDrops[1].ammoLoose == 20;
+    LootDrop gun = dup;
+    gun.pos = dup.pos + Vec2{ 3.0f, 0.0f };
+    gun.hasInst = true;
+    gun.inst.id = gun.wid;
+    gun.inst.uid = 7;
+    gun.inst.reserveAmmo = 5;
+    addLootDrop(gun);
+    LootDrop other = gun;
+    other.inst.uid = 8;
+    addLootDrop(other);
+    LootDrop past = dup;   // the gun is nearer, the ammo pile further on matches
+    past.pos = dup.pos + Vec2{ 4.0f, 0.0f };
+    addLootDrop(past);
+    merged &= (int)lootDrops.size() == before + 2 && lootDrops[1].ammoLoose == 30;
+    before = (int)lootDrops.size();
+    updateLoot();
+    bool capped = (int)lootDrops.size() == cfg::LootMaxDrops;
+    if (!same || !merged || !capped) rig.allMatch = false;
+
+    std::printf("[bench] loot, %d drops x%d queries: full scan %.3f ms | cell index %.3f ms (%d found)%s | cleanup %d -> %d drops%s\n",
+        before, (int)probes.size(),
+        std::chrono::duration<double, std::milli>(q1 - q0).count(),
+        std::chrono::duration<double, std::milli>(q2 - q1).count(), found,
+        same ? "" : " LOOT MISMATCH", before, (int)lootDrops.size(),
+        merged && capped ? "" : " LIFECYCLE FAILED");
+    lootDrops.clear();
+    lootIndex.dirty = true;
+}
+
+// Foliage along sight rays: density grid walk vs testing the leaf rects
+// of every trunk near the ray
+void Game::benchFoliage(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+
+    const int rays = 5000;
+    std::vector<Vec2> eyes, targets;
+    for (int i = 0; i < rays; ++i) {
+        int e = rig.navCell(20, 20, n - 21, n - 21);
+        if (e < 0) continue;
+        float ang = frand(0.0f, 6.28318f);
+        float len = frand(2.0f, 10.0f) * cfg::TileSize;
+        eyes.push_back(tileCenterOf(e));
+        targets.push_back(tileCenterOf(e) + Vec2{ std::cos(ang) * len, std::sin(ang) * len });
+    }
+    const int count = (int)eyes.size();
+    const int perTrunk = cfg::FoliagePerTrunk;   // leaves are stored trunk by trunk
+
+    // Liang-Barsky: does a..b cross the rect
+    auto crosses = [](const Vec2& a, const Vec2& b, const SDL_FRect& r) {
+        float t0 = 0.0f, t1 = 1.0f;
+        float dx = b.x - a.x, dy = b.y - a.y;
+        const float pp[4] = { -dx, dx, -dy, dy };
+        const float qq[4] = { a.x - r.x, r.x + r.w - a.x, a.y - r.y, r.y + r.h - a.y };
+        for (int k = 0; k < 4; ++k) {
+            if (pp[k] == 0.0f) { if (qq[k] < 0.0f) return false; continue; }
+            float t = qq[k] / pp[k];
+            if (pp[k] < 0.0f) t0 = std::max(t0, t); else t1 = std::min(t1, t);
+            if (t0 > t1) return false;
+        }
+        return true;
+        };
+
+    std::vector<int> leafHits(count, 0);
+    std::vector<float> density(count, 0.0f);
+    const int reach = (int)std::ceil(cfg::FoliageRadiusPx / cfg::TileSize) + 1;
+    auto f0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) {
+        const Vec2& a = eyes[i];
+        const Vec2& b = targets[i];
+        int c0 = std::max(0, (int)std::floor(std::min(a.x, b.x) / cfg::TileSize) - reach);
+        int c1 = std::min(n - 1, (int)std::floor(std::max(a.x, b.x) / cfg::TileSize) + reach);
+        int r0 = std::max(0, (int)std::floor(std::min(a.y, b.y) / cfg::TileSize) - reach);
+        int r1 = std::min(n - 1, (int)std::floor(std::max(a.y, b.y) / cfg::TileSize) + reach);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c) {
+                int ti = trunkIndex[r * n + c];
+                if (ti < 0) continue;
+                for (int k = 0; k < perTrunk; ++k) leafHits[i] += crosses(a, b, leaves[ti * perTrunk + k].rect) ? 1 : 0;
+            }
+    }
+    auto f1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) density[i] = foliageAlong(eyes[i], targets[i]);
+    auto f2 = std::chrono::high_resolution_clock::now();
+
+    int leafy = 0, agree = 0;
+    double sumDensity = 0.0;
+    for (int i = 0; i < count; ++i) {
+        leafy += leafHits[i] > 0 ? 1 : 0;
+        agree += (leafHits[i] > 0) == (density[i] > 0.0f) ? 1 : 0;
+        sumDensity += density[i];
+    }
+    std::printf("[bench] foliage %d rays <= 10 tiles: leaf rects %.3f ms (%d through leaves) | density grid %.3f ms (mean %.2f tiles of cover, %.1f%% agree on any cover)\n",
+        count, std::chrono::duration<double, std::milli>(f1 - f0).count(), leafy,
+        std::chrono::duration<double, std::milli>(f2 - f1).count(), sumDensity / count,
+        100.0 * agree / std::max(1, count));
+}
+
+// Perception: brain + updateAI + overlay each asking every tick, cached or not
+void Game::benchPerception(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+
+    actors.clear();
+    squads.clear();
+    perception.clear();
+    fovMasks.clear();
+    for (auto& v : factionVis) v.tick = 0;
+    invalidateActorGrid();
+    pathQueue.clear();
+    const float T = (float)cfg::TileSize;
+    for (int i = 0; i < 24; ++i) {
+        int cell = rig.navCell(n / 2 - 20, n / 2 - 20, n / 2 + 20, n / 2 + 20);
+        if (cell < 0) continue;
+        placeSquad(i % 2 ? Faction::Axis : Faction::Allies,
+            int((cell % n + 0.5f) * T), int((cell / n + 0.5f) * T), 4);
+    }
+    for (Actor& a : actors) {
+        float ang = frand(0.0f, 6.28318f);
+        a.facing = Vec2{ std::cos(ang), std::sin(ang) };
+    }
+
+    const int ticks = 60;
+    const int asksPerTick = 3;
+    Vec2 p;
+    int idx;
+    bool seen;
+    int threats = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < ticks; ++t)
+        for (int k = 0; k < asksPerTick; ++k) {
+            ++simTick;   // nothing carried over between asks, FOV masks included
+            for (const Actor& a : actors) threats += scanThreat(a, p, idx, seen) ? 1 : 0;
+        }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    perceptionScans = perceptionHits = 0;
+    perceptionLod = false;   // same answers only if nobody is skipped
+    for (int t = 0; t < ticks; ++t) {
+        ++simTick;
+        for (int k = 0; k < asksPerTick; ++k)
+            for (const Actor& a : actors) threats -= acquireThreat(a, p, idx, seen) ? 1 : 0;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    perceptionLod = true;
+
+    if (threats != 0) rig.allMatch = false;
+    std::printf("[bench] perception, %d actors x%d asks x%d ticks: every ask scans %.3f ms | per-tick cache %.3f ms (%d scans, %d hits)%s\n",
+        (int)actors.size(), asksPerTick, ticks,
+        std::chrono::duration<double, std::milli>(t1 - t0).count(),
+        std::chrono::duration<double, std::milli>(t2 - t1).count(),
+        perceptionScans, perceptionHits, threats == 0 ? "" : " RESULT MISMATCH");
+
+    // Overlay masks vs the per-target rays threat checks use: what a mask
+    // lookup would cost and how often its tile answer misses the exact ray
+    int pairs = 0, rayVis = 0, maskVis = 0, differ = 0;
+    long long maskTiles = 0;
+    auto f0 = std::chrono::high_resolution_clock::now();
+    for (const Actor& a : actors)
+        for (const Actor& o : actors) {
+            if (&a == &o || !areEnemies(a.team, o.team) || !inVisionCone(a, o.pos)) continue;
+            rayVis += losClear(a.pos, o.pos) ? 1 : 0;
+        }
+    auto f1 = std::chrono::high_resolution_clock::now();
+    FovMask m;
+    for (const Actor& a : actors) {
+        computeFov(a, m);
+        for (const Actor& o : actors) {
+            if (&a == &o || !areEnemies(a.team, o.team) || !inVisionCone(a, o.pos)) continue;
+            maskVis += m.test((int)std::floor(o.pos.x / cfg::TileSize), (int)std::floor(o.pos.y / cfg::TileSize)) ? 1 : 0;
+        }
+    }
+    auto f2 = std::chrono::high_resolution_clock::now();
+    for (const Actor& a : actors) {
+        computeFov(a, m);
+        for (uint64_t w : m.bits) maskTiles += popCount64(w);
+        for (const Actor& o : actors) {
+            if (&a == &o || !areEnemies(a.team, o.team) || !inVisionCone(a, o.pos)) continue;
+            bool vis = m.test((int)std::floor(o.pos.x / cfg::TileSize), (int)std::floor(o.pos.y / cfg::TileSize));
+            differ += vis != losClear(a.pos, o.pos) ? 1 : 0;
+            ++pairs;
+        }
+    }
+    std::printf("[bench] FOV overlay: %d enemy pairs in cone: per-target rays %.3f ms (%d visible) | mask lookups %.3f ms (%d visible, %.0f tiles/actor, %d differ from the ray)\n",
+        pairs, std::chrono::duration<double, std::milli>(f1 - f0).count(), rayVis,
+        std::chrono::duration<double, std::milli>(f2 - f1).count(), maskVis,
+        actors.empty() ? 0.0 : double(maskTiles) / actors.size(), differ);
+
+    // Faction table vs every member asking sees() about every enemy
+    {
+        ++simTick;
+        const int slots = (int)actors.size() + 1;
+        std::vector<uint16_t> refBy(slots, 0);
+        std::vector<int> refNearest(slots, -1);
+        std::vector<float> refD2(slots, std::numeric_limits<float>::max());
+        int pairCount = 0;
+        auto v0 = std::chrono::high_resolution_clock::now();
+        for (int o = 0; o < (int)actors.size(); ++o) {
+            const Actor& a = actors[o];
+            for (int i = 0; i < (int)actors.size(); ++i) {
+                const Actor& t = actors[i];
+                bool los = false;
+                if (!t.alive() || !areEnemies(a.team, t.team) || !sees(a, t.pos, los)) continue;
+                ++refBy[i + 1];
+                ++pairCount;
+                float d2 = lenSq(t.pos - a.pos);
+                if (d2 < refD2[i + 1]) { refD2[i + 1] = d2; refNearest[i + 1] = o + 1; }
+            }
+        }
+        auto v1 = std::chrono::high_resolution_clock::now();
+        ++simTick;   // same LOS work for the table, nothing cached
+        perceptionLod = false;   // every member rescans
+        for (int f = 0; f < 4; ++f) factionVisFor((Faction)f);
+        perceptionLod = true;
+        auto v2 = std::chrono::high_resolution_clock::now();
+
+        bool same = true;
+        for (int t = 1; t < slots; ++t) {
+            uint16_t by = 0;
+            int nearest = -1;
+            float bestD2 = std::numeric_limits<float>::max();
+            for (const FactionVis& fv : factionVis) {
+                by += fv.visibleBy[t];
+                if (fv.nearestObs[t] >= 0 && fv.nearestD2[t] < bestD2) { bestD2 = fv.nearestD2[t]; nearest = fv.nearestObs[t]; }
+            }
+            same &= by == refBy[t] && nearest == refNearest[t];
+        }
+        if (!same) rig.allMatch = false;
+        std::printf("[bench] faction vis, %d actors: per-member sees %.3f ms | 4 faction tables %.3f ms (%d sightings)%s\n",
+            (int)actors.size(), std::chrono::duration<double, std::milli>(v1 - v0).count(),
+            std::chrono::duration<double, std::milli>(v2 - v1).count(), pairCount,
+            same ? " match" : " TABLE MISMATCH");
+    }
+
+    // Cone stage alone, 1k observers x 1k targets: the old acos test vs
+    // ConeQuery::test vs the packed batch
+    {
+        const int obs = 1000, tgts = 1000;
+        const float span = 30.0f * T;
+        const Vec2 mid = tileCenterOf((n / 2) * n + n / 2);
+        std::vector<ConeQuery> qs(obs);
+        for (int i = 0; i < obs; ++i) {
+            ConeQuery q = coneFor(actors[0]);
+            float ang = frand(0.0f, 6.28318f);
+            q.ox = mid.x + frand(-span, span);
+            q.oy = mid.y + frand(-span, span);
+            q.fx = std::cos(ang);
+            q.fy = std::sin(ang);
+            qs[i] = q;
+        }
+        std::vector<float> xs(tgts), ys(tgts);
+        std::vector<uint8_t> trees(tgts), pass(tgts);
+        for (int k = 0; k < tgts; ++k) {
+            xs[k] = mid.x + frand(-span, span);
+            ys[k] = mid.y + frand(-span, span);
+            trees[k] = frand(0.0f, 1.0f) < 0.2f ? 1 : 0;
+        }
+
+        // The old inVisionCone maths on the same inputs (actors[0] stats, as above)
+        const float visionRange = actors[0].visionRange * (1.0f + 0.12f * (float)mission.alarmLevel);
+        const float halfDeg = actors[0].visionFOVDeg * 0.5f;
+        const float concealMul = (mission.alarmLevel >= 3) ? 0.75f : (mission.alarmLevel >= 1 ? 0.65f : 0.55f);
+        auto acosTest = [&](const ConeQuery& q, int k) {
+            Vec2 to{ xs[k] - q.ox, ys[k] - q.oy };
+            float dist = length(to);
+            if (dist < 1e-3f) return false;
+            float effRange = visionRange, fovMul = 1.0f;
+            if (trees[k] && dist > cfg::TileSize * 1.2f) { effRange *= concealMul; fovMul = 0.85f; }
+            if (dist > effRange) return false;
+            Vec2 dir = normalize(to);
+            float dot = q.fx * dir.x + q.fy * dir.y;
+            float angDeg = std::acos(std::clamp(dot, -1.0f, 1.0f)) * 180.0f / 3.14159265f;
+            return angDeg <= halfDeg * fovMul;
+            };
+
+        long long refHits = 0, scalarHits = 0, batchHits = 0, edge = 0;
+        std::vector<uint8_t> scalarOut((size_t)obs * tgts);
+        auto c0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < obs; ++i)
+            for (int k = 0; k < tgts; ++k) refHits += acosTest(qs[i], k) ? 1 : 0;
+        auto c1 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < obs; ++i)
+            for (int k = 0; k < tgts; ++k) {
+                bool hit = qs[i].test(xs[k], ys[k], trees[k] != 0);
+                scalarOut[(size_t)i * tgts + k] = hit ? 1 : 0;
+                scalarHits += hit ? 1 : 0;
+            }
+        auto c2 = std::chrono::high_resolution_clock::now();
+        bool same = true;
+        for (int i = 0; i < obs; ++i) {
+            coneCullBatch(qs[i], xs.data(), ys.data(), trees.data(), tgts, pass.data());
+            for (int k = 0; k < tgts; ++k) {
+                batchHits += pass[k];
+                same &= pass[k] == scalarOut[(size_t)i * tgts + k];
+            }
+        }
+        auto c3 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < obs; ++i)
+            for (int k = 0; k < tgts; ++k) edge += acosTest(qs[i], k) != (scalarOut[(size_t)i * tgts + k] != 0) ? 1 : 0;
+        if (!same) rig.allMatch = false;
+
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+        std::printf("[bench] cone %dx%d: acos %.3f ms (%lld in) | cosine scalar %.3f ms (%lld in, %lld on the edge) | %s batch %.3f ms (%lld in)%s\n",
+            obs, tgts, ms(c0, c1), refHits, ms(c1, c2), scalarHits, edge,
+#ifdef PF_CONE_SSE2
+            "SSE2",
+#else
+            "scalar",
+#endif
+            ms(c2, c3), batchHits, same ? "" : " BATCH MISMATCH");
+    }
+}
+
+// Actor grid vs scanning the whole vector, 1000 actors in a 100x100 tile area:
+// crowding pairs, bullet-sized range queries and nearest-enemy lookups
+void Game::benchActorGrid(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+    const float T = (float)cfg::TileSize;
+
+    {
+        actors.clear();
+        squads.clear();
+        for (int i = 0; i < 250; ++i) {
+            int cell = rig.navCell(n / 2 - 50, n / 2 - 50, n / 2 + 50, n / 2 + 50);
+            if (cell < 0) continue;
+            placeSquad((Faction)(i % 4), int((cell % n + 0.5f) * T), int((cell / n + 0.5f) * T), 4);
+        }
+        ++simTick;
+        const int count = (int)actors.size();
+        const float minSep = cfg::PawnSize * 0.9f;
+        std::vector<Vec2> probes;
+        for (int i = 0; i < 2000; ++i) {
+            probes.push_back(Vec2{ (n / 2 + frand(-50.0f, 50.0f)) * T, (n / 2 + frand(-50.0f, 50.0f)) * T });
+        }
+        const unsigned axisFoes = enemyFactionMask(Faction::Axis);
+
+        long long bPairs = 0, bNear = 0;
+        std::vector<int> bNearest(probes.size(), -1);
+        auto g0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < count; ++i)
+            for (int j = i + 1; j < count; ++j) bPairs += lenSq(actors[j].pos - actors[i].pos) <= minSep * minSep ? 1 : 0;
+        for (const Vec2& q : probes)
+            for (const Actor& a : actors) bNear += (axisFoes & (1u << (int)a.team)) && lenSq(a.pos - q) <= 70.0f * 70.0f ? 1 : 0;
+        for (size_t k = 0; k < probes.size(); ++k) {
+            float best = std::numeric_limits<float>::max();
+            for (int i = 0; i < count; ++i) {
+                if (!(axisFoes & (1u << (int)actors[i].team))) continue;
+                float d2 = lenSq(actors[i].pos - probes[k]);
+                if (d2 < best) { best = d2; bNearest[k] = i; }
+            }
+        }
+        auto g1 = std::chrono::high_resolution_clock::now();
+        invalidateActorGrid();
+        const ActorGrid& grid = actorGridNow();
+        auto g2 = std::chrono::high_resolution_clock::now();
+        long long gPairs = 0, gNear = 0;
+        int nearestSame = 0;
+        for (int i = 0; i < count; ++i) {
+            grid.query(actors[i].pos.x, actors[i].pos.y, minSep, 0xFu, [&](int j) {
+                gPairs += j > i && lenSq(actors[j].pos - actors[i].pos) <= minSep * minSep ? 1 : 0;
+                });
+        }
+        for (const Vec2& q : probes) {
+            grid.query(q.x, q.y, 70.0f, axisFoes, [&](int i) { gNear += lenSq(actors[i].pos - q) <= 70.0f * 70.0f ? 1 : 0; });
+        }
+        for (size_t k = 0; k < probes.size(); ++k) {
+            nearestSame += grid.nearest(actors, probes[k], axisFoes) == bNearest[k] ? 1 : 0;
+        }
+        auto g3 = std::chrono::high_resolution_clock::now();
+
+        bool same = bPairs == gPairs && bNear == gNear && nearestSame == (int)probes.size();
+        if (!same) rig.allMatch = false;
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+        std::printf("[bench] actor grid, %d actors: full scans %.3f ms | grid build %.3f ms + queries %.3f ms (%lld crowding pairs, %lld in bullet range, %d nearest)%s\n",
+            count, ms(g0, g1), ms(g1, g2), ms(g2, g3), gPairs, gNear, nearestSame,
+            same ? " match" : " GRID MISMATCH");
+    }
+
+    // Canopy see-through, same 1000 actors: every leaf vs every pawn, as
+    // drawWorld used to, against the per-tile leaf bins
+    {
+        std::vector<char> under(leaves.size(), 0);
+        bool oldPlayerUnder = false;
+        auto c0 = std::chrono::high_resolution_clock::now();
+        for (size_t li = 0; li < leaves.size(); ++li) {
+            const SDL_FRect& lr = leaves[li].rect;
+            if (playerPresent) {
+                SDL_FRect pr = rectFrom(player.pos, player.w, player.h);
+                if (SDL_HasIntersectionF(&lr, &pr)) { under[li] = 1; oldPlayerUnder = true; }
+            }
+            for (const auto& e : actors) {
+                if (!e.alive()) continue;
+                SDL_FRect er = rectFrom(e.pos, e.w, e.h);
+                if (SDL_HasIntersectionF(&lr, &er)) { under[li] = 1; break; }
+            }
+        }
+        auto c1 = std::chrono::high_resolution_clock::now();
+        markLeavesUnderPawns();
+        auto c2 = std::chrono::high_resolution_clock::now();
+
+        int marked = 0;
+        bool same = playerUnderCanopy == oldPlayerUnder;
+        for (size_t li = 0; li < leaves.size(); ++li) {
+            bool now = leafUnderFrame[li] == canopyFrame;
+            marked += now ? 1 : 0;
+            same &= now == (under[li] != 0);
+        }
+        if (!same) rig.allMatch = false;
+        std::printf("[bench] canopy, %d leaves x%d pawns: every leaf %.3f ms | tile bins %.3f ms (%d see-through)%s\n",
+            (int)leaves.size(), (int)actors.size() + (playerPresent ? 1 : 0),
+            std::chrono::duration<double, std::milli>(c1 - c0).count(),
+            std::chrono::duration<double, std::milli>(c2 - c1).count(), marked,
+            same ? " match" : " CANOPY MISMATCH");
+    }
+}
+
+// Hearing: the player walks (and fires now and then) for 3 s past 400
+// listeners. Old: a ping per frame, every listener tests every ping.
+// New: coalesced pings, listeners test only their cell's bin.
+void Game::benchHearing(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+    const float T = (float)cfg::TileSize;
+
+    actors.clear();
+    squads.clear();
+    for (int i = 0; i < 100; ++i) {
+        int cell = rig.navCell(n / 2 - 60, n / 2 - 60, n / 2 + 60, n / 2 + 60);
+        if (cell < 0) continue;
+        placeSquad(Faction::Axis, int((cell % n + 0.5f) * T), int((cell / n + 0.5f) * T), 4);
+    }
+    bool hadPlayer = playerPresent;
+    Vec2 playerWas = player.pos;
+    playerPresent = false;   // hearing only, nothing to see
+    sounds.clear();
+    soundGrid.dirty = true;
+
+    const float dt = 1.0f / 60.0f;
+    const int frames = 180;
+    const float stepR = cfg::FootstepHearWalkTiles * cfg::TileSize;
+    const float shotR = weaponNoiseRadiusPx(player.weapon.id);
+    auto noiseAt = [&](int f) { return Vec2{ (n / 2 - 40) * T + f * 50.0f * dt, n / 2 * T }; };
+
+    std::vector<SoundPing> oldPings;
+    std::vector<uint8_t> oldHeardBy((size_t)frames * actors.size()), newHeardBy(oldHeardBy.size());
+    long long oldTests = 0, newTests = 0;
+    int oldHeard = 0, newHeard = 0, peakOld = 0, peakNew = 0;
+    auto h0 = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (auto& p0 : oldPings) { p0.ttl -= dt; p0.radiusPx = std::max(0.f, p0.radiusPx - (cfg::TileSize * dt * 3.f)); }
+        oldPings.erase(std::remove_if(oldPings.begin(), oldPings.end(),
+            [](const SoundPing& p0) { return p0.ttl <= 0.f || p0.radiusPx <= 0.f; }), oldPings.end());
+        oldPings.push_back({ noiseAt(f), stepR, cfg::HearDecayS * 0.7f });
+        if (f % 20 == 0) oldPings.push_back({ noiseAt(f), shotR, cfg::HearDecayS * 0.7f });
+        peakOld = std::max(peakOld, (int)oldPings.size());
+        for (size_t i = 0; i < actors.size(); ++i) {
+            bool any = false;
+            for (const auto& p0 : oldPings) { ++oldTests; any |= length(p0.pos - actors[i].pos) <= p0.radiusPx; }
+            oldHeard += any ? 1 : 0;
+            oldHeardBy[f * actors.size() + i] = any ? 1 : 0;
+        }
+    }
+    auto h1 = std::chrono::high_resolution_clock::now();
+    int coalescedWas = soundsCoalesced;
+    for (int f = 0; f < frames; ++f) {
+        ++simTick;
+        gameTimeS += dt;
+        updateSounds(dt);
+        emitSound(noiseAt(f), stepR, cfg::HearDecayS * 0.7f, -1);
+        if (f % 20 == 0) emitSound(noiseAt(f), shotR, cfg::HearDecayS * 0.7f, -1);
+        peakNew = std::max(peakNew, (int)sounds.size());
+        hearTestsTick = 0;
+        float score;
+        for (size_t i = 0; i < actors.size(); ++i) {
+            bool heard = loudestPing(actors[i], score) >= 0;
+            newHeard += heard ? 1 : 0;
+            newHeardBy[f * actors.size() + i] = heard ? 1 : 0;
+        }
+        newTests += hearTestsTick;
+    }
+    auto h2 = std::chrono::high_resolution_clock::now();
+
+    // Reach: nobody hears a coalesced ping who heard none of the separate
+    // ones, and everybody within this frame's noise hears something
+    int overHeard = 0, missed = 0;
+    for (int f = 0; f < frames; ++f) {
+        const float r = f % 20 == 0 ? std::max(stepR, shotR) : stepR;
+        for (size_t i = 0; i < actors.size(); ++i) {
+            const size_t k = f * actors.size() + i;
+            overHeard += newHeardBy[k] && !oldHeardBy[k] ? 1 : 0;
+            missed += !newHeardBy[k] && length(noiseAt(f) - actors[i].pos) <= r ? 1 : 0;
+        }
+    }
+    if (overHeard != 0 || missed != 0) rig.allMatch = false;
+
+    std::printf("[bench] hearing, %d listeners x%d frames: ping per frame %.3f ms (peak %d pings, %lld tests, %d heard) | coalesced + bins %.3f ms (peak %d pings, %d coalesced, %lld tests, %d heard)%s\n",
+        (int)actors.size(), frames,
+        std::chrono::duration<double, std::milli>(h1 - h0).count(), peakOld, oldTests, oldHeard,
+        std::chrono::duration<double, std::milli>(h2 - h1).count(), peakNew,
+        soundsCoalesced - coalescedWas, newTests, newHeard,
+        overHeard == 0 && missed == 0 ? "" : " REACH MISMATCH");
+    sounds.clear();
+    soundGrid.dirty = true;
+    playerPresent = hadPlayer;
+    player.pos = playerWas;
+}
+
+// Bullets: the same 2000 fast shots through benchHearing's 400 listeners at
+// 10 Hz and 240 Hz. A shot that ends a tick still flying although its
+// move crossed a wall tile or a pawn's circle has tunnelled.
+void Game::benchBullets(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+    const float T = (float)cfg::TileSize;
+
+    {
+        bool hadPlayer = playerPresent;
+        playerPresent = false;
+        MissionState missionWas = mission;
+        std::vector<Bullet> shots;
+        for (int i = 0; i < 2000; ++i) {
+            int cell = rig.navCell(n / 2 - 60, n / 2 - 60, n / 2 + 60, n / 2 + 60);
+            if (cell < 0) continue;
+            Bullet b;
+            b.pos = Vec2{ (cell % n + 0.5f) * T, (cell / n + 0.5f) * T };
+            float ang = frand(0.0f, 6.2831853f);
+            b.dir = Vec2{ std::cos(ang), std::sin(ang) };
+            b.speed = 900.0f;
+            b.maxRange = 900.0f;
+            b.dmg = 0;   // nobody dies, every run sees the same targets
+            b.src = Faction::Allies;
+            shots.push_back(b);
+        }
+        auto tunnelled = [&](const Vec2& from, const Vec2& to) {
+            if (!losClear(from, to)) return true;
+            for (const Actor& a : actors)
+                if (segmentPointDist(from, to, a.pos) < a.w * 0.5f + 2.f) return true;
+            return false;
+            };
+        struct Run { double ms = 0; int hits = 0, tunnels = 0; };
+        auto pointRun = [&](float dt) {
+            Run out;
+            std::vector<Bullet> bs = shots;
+            auto b0 = std::chrono::high_resolution_clock::now();
+            while (!bs.empty()) {
+                std::vector<Bullet> keep;
+                for (Bullet b : bs) {
+                    b.prev = b.pos;
+                    b.pos = b.pos + b.dir * (b.speed * dt);
+                    b.traveled += b.speed * dt;
+                    SDL_FRect r{ b.pos.x - 2.f, b.pos.y - 2.f, 4.f, 4.f };
+                    if (b.traveled > b.maxRange || collideSolid(r)) continue;
+                    bool hit = false;
+                    for (const Actor& a : actors) hit |= length(a.pos - b.pos) < a.w * 0.5f + 2.f;
+                    if (hit) { ++out.hits; continue; }
+                    keep.push_back(b);
+                }
+                auto p0 = std::chrono::high_resolution_clock::now();
+                for (const Bullet& b : keep) out.tunnels += tunnelled(b.prev, b.pos) ? 1 : 0;
+                b0 += std::chrono::high_resolution_clock::now() - p0;
+                bs.swap(keep);
+            }
+            out.ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - b0).count();
+            return out;
+            };
+        auto sweptRun = [&](float dt) {
+            Run out;
+            bullets.clear();
+            for (const Bullet& b : shots) bullets.push(b);
+            int hitsWas = mission.shotsHit;
+            auto b0 = std::chrono::high_resolution_clock::now();
+            while (!bullets.empty()) {
+                updateBullets(dt);
+                auto p0 = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < bullets.size(); ++i)
+                    out.tunnels += tunnelled(Vec2{ bullets.prevX[i], bullets.prevY[i] }, Vec2{ bullets.x[i], bullets.y[i] }) ? 1 : 0;
+                b0 += std::chrono::high_resolution_clock::now() - p0;
+            }
+            out.ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - b0).count();
+            out.hits = mission.shotsHit - hitsWas;
+            return out;
+            };
+        Run pSlow = pointRun(0.1f), pFast = pointRun(1.0f / 240.0f);
+        Run sSlow = sweptRun(0.1f), sFast = sweptRun(1.0f / 240.0f);
+        // Hit counts are only reported: a graze at a tick boundary can go either
+        // way on float noise. Tunnelling is the correctness check.
+        bool ok = sSlow.tunnels == 0 && sFast.tunnels == 0;
+        if (!ok) rig.allMatch = false;
+        std::printf("[bench] bullets, %d shots at %.0f px/s: point test 10 Hz %.3f ms (%d hits, %d tunnelled) / 240 Hz %.3f ms (%d hits, %d tunnelled) | swept 10 Hz %.3f ms (%d hits, %d tunnelled) / 240 Hz %.3f ms (%d hits, %d tunnelled)%s\n",
+            (int)shots.size(), 900.0f,
+            pSlow.ms, pSlow.hits, pSlow.tunnels, pFast.ms, pFast.hits, pFast.tunnels,
+            sSlow.ms, sSlow.hits, sSlow.tunnels, sFast.ms, sFast.hits, sFast.tunnels,
+            ok ? "" : " BULLET MISMATCH");
+        mission = missionWas;
+        barks.clear();
+        playerPresent = hadPlayer;
+    }
+
+    // Bullet bookkeeping in a sustained exchange: 600 in flight, each
+    // expiring at its range and replaced the same tick. Old: AoS vector,
+    // a dead flag vector and a rebuilt survivor vector per tick. New: the
+    // pool's integrate + swap-remove.
+    {
+        std::vector<Bullet> spawns;
+        for (int i = 0; i < 997; ++i) {
+            Bullet b;
+            float ang = frand(0.0f, 6.2831853f);
+            b.pos = Vec2{ frand(0.0f, n * T), frand(0.0f, n * T) };
+            b.dir = Vec2{ std::cos(ang), std::sin(ang) };
+            b.speed = frand(520.0f, 900.0f);
+            b.maxRange = frand(200.0f, 900.0f);
+            spawns.push_back(b);
+        }
+        const int live = 600, ticks = 2000;
+        const float dt = 1.0f / 60.0f;
+
+        std::vector<Bullet> aos;
+        int nextOld = 0, expiredOld = 0;
+        for (int i = 0; i < live; ++i) aos.push_back(spawns[nextOld++ % spawns.size()]);
+        auto o0 = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            for (auto& b : aos) {
+                float step = b.speed * dt;
+                b.prev = b.pos;
+                b.pos = b.pos + b.dir * step;
+                b.traveled += step;
+            }
+            std::vector<bool> dead(aos.size(), false);
+            for (int i = 0; i < (int)aos.size(); ++i) dead[i] = aos[i].traveled > aos[i].maxRange;
+            std::vector<Bullet> alive;
+            alive.reserve(aos.size());
+            for (int i = 0; i < (int)aos.size(); ++i)
+                if (!dead[i]) alive.push_back(aos[i]);
+            expiredOld += (int)(aos.size() - alive.size());
+            aos.swap(alive);
+            while ((int)aos.size() < live) aos.push_back(spawns[nextOld++ % spawns.size()]);
+        }
+        auto o1 = std::chrono::high_resolution_clock::now();
+
+        bullets.clear();
+        int nextNew = 0, expiredNew = 0;
+        for (int i = 0; i < live; ++i) bullets.push(spawns[nextNew++ % spawns.size()]);
+        size_t capAfterWarmup = 0;
+        auto n0 = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            bullets.integrate(dt);
+            deadBullets.clear();
+            for (int i = 0; i < bullets.size(); ++i)
+                if (bullets.traveled[i] > bullets.maxRange[i]) deadBullets.push_back(i);
+            for (auto it = deadBullets.rbegin(); it != deadBullets.rend(); ++it) bullets.swapRemove(*it);
+            expiredNew += (int)deadBullets.size();
+            while (bullets.size() < live) bullets.push(spawns[nextNew++ % spawns.size()]);
+            if (t == 0) capAfterWarmup = bullets.x.capacity();
+        }
+        auto n1 = std::chrono::high_resolution_clock::now();
+
+        // Same flights in a different order: compare the sorted distances
+        std::vector<float> travOld, travNew(bullets.traveled.begin(), bullets.traveled.begin() + bullets.size());
+        for (const Bullet& b : aos) travOld.push_back(b.traveled);
+        std::sort(travOld.begin(), travOld.end());
+        std::sort(travNew.begin(), travNew.end());
+        bool same = expiredOld == expiredNew && travOld == travNew;
+        bool noGrowth = bullets.x.capacity() == capAfterWarmup;
+        if (!same || !noGrowth) rig.allMatch = false;
+        std::printf("[bench] bullet pool, %d live x%d ticks: AoS + rebuild %.3f ms (%d expired) | SoA swap-remove %.3f ms (%d expired)%s%s\n",
+            live, ticks,
+            std::chrono::duration<double, std::milli>(o1 - o0).count(), expiredOld,
+            std::chrono::duration<double, std::milli>(n1 - n0).count(), expiredNew,
+            same ? "" : " POOL MISMATCH", noGrowth ? "" : " POOL GREW");
+        bullets.clear();
+    }
+}
+
+// Perception LOD: squads spread over the whole map, player in the middle.
+// Full rate grows with every actor added; LOD only with the ones nearby.
+void Game::benchPerceptionLod(BenchRig& rig) {
+    const int n = map.cols;   // the square map benchLargeNav built
+    const float T = (float)cfg::TileSize;
+    const int ticks = 60;
+    Vec2 p;
+    int idx;
+    bool seen;
+
+    auto lodBench = [&](int squadCount) {
+        actors.clear();
+        squads.clear();
+        for (int i = 0; i < squadCount; ++i) {
+            int cell = rig.navCell(8, 8, n - 9, n - 9);
+            if (cell < 0) continue;
+            placeSquad(i % 2 ? Faction::Axis : Faction::Allies,
+                int((cell % n + 0.5f) * T), int((cell / n + 0.5f) * T), 4);
+        }
+
+        const float dt = 1.0f / 60.0f;
+        double ms[2];
+        int scans[2];
+        for (int lod = 0; lod < 2; ++lod) {
+            perceptionLod = lod != 0;
+            perception.clear();
+            fovMasks.clear();
+            for (auto& v : factionVis) v.tick = 0;
+            invalidateActorGrid();
+            perceptionScans = perceptionHits = 0;
+            auto l0 = std::chrono::high_resolution_clock::now();
+            for (int t = 0; t < ticks; ++t) {
+                ++simTick;
+                gameTimeS += dt;
+                for (int f = 0; f < 4; ++f) factionVisFor((Faction)f);   // squad brains ask first
+                for (const Actor& a : actors) acquireThreat(a, p, idx, seen);
+            }
+            auto l1 = std::chrono::high_resolution_clock::now();
+            ms[lod] = std::chrono::duration<double, std::milli>(l1 - l0).count() / ticks;
+            scans[lod] = perceptionScans;
+        }
+        perceptionLod = true;
+        std::printf("[bench] perception LOD, %d actors x%d ticks: full rate %.3f ms/tick (%d scans) | LOD %.3f ms/tick (%d scans)\n",
+            (int)actors.size(), ticks, ms[0], scans[0], ms[1], scans[1]);
+        };
+
+    Vec2 playerWas = player.pos;
+    player.pos = Vec2{ n * T * 0.5f, n * T * 0.5f };
+    lodBench(100);
+    lodBench(400);
+    player.pos = playerWas;
+
+    actors.clear();
+    squads.clear();
+    perception.clear();
+    fovMasks.clear();
+    for (auto& v : factionVis) v.tick = 0;
+    invalidateActorGrid();
+}